@@ -0,0 +1,92 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_CHUNK_MIN 4096
+#define ARENA_ALIGN 16
+
+struct chunk {
+    struct chunk *next;
+    size_t used;
+    size_t size;
+    /* chunk data follows the header */
+};
+
+struct arena {
+    struct chunk *first;
+    struct chunk *cur; /* chunk currently being bumped */
+};
+
+static char *chunk_data(struct chunk *c)
+{
+    return (char *)(c + 1);
+}
+
+static struct chunk *chunk_create(size_t min_size)
+{
+    size_t size = ARENA_CHUNK_MIN;
+    while (size < min_size)
+        size *= 2;
+
+    struct chunk *c = malloc(sizeof(struct chunk) + size);
+    c->next = NULL;
+    c->used = 0;
+    c->size = size;
+    return c;
+}
+
+arena_t *arena_create(void)
+{
+    arena_t *a = malloc(sizeof(arena_t));
+    a->first = a->cur = chunk_create(0);
+    return a;
+}
+
+void arena_destroy(arena_t *a)
+{
+    struct chunk *c = a->first;
+    while (c) {
+        struct chunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    free(a);
+}
+
+void *arena_alloc(arena_t *a, size_t size)
+{
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    struct chunk *c = a->cur;
+    while (c->size - c->used < size) {
+        if (!c->next)
+            c->next = chunk_create(size);
+        c = c->next;
+    }
+    a->cur = c;
+
+    void *p = chunk_data(c) + c->used;
+    c->used += size;
+    return p;
+}
+
+void *arena_realloc(arena_t *a, void *ptr, size_t old_size, size_t new_size)
+{
+    if (new_size <= old_size)
+        return ptr;
+
+    void *p = arena_alloc(a, new_size);
+    if (ptr)
+        memcpy(p, ptr, old_size);
+    return p;
+}
+
+char *arena_strdup(arena_t *a, const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *p = arena_alloc(a, len);
+    memcpy(p, s, len);
+    return p;
+}
+
+arena_t *command_arena = NULL;
@@ -0,0 +1,34 @@
+#ifndef SHELL_ARENA_H
+#define SHELL_ARENA_H
+
+#include <stddef.h>
+
+/*
+ * A bump allocator for objects that all share one lifetime. Allocations are
+ * O(1) pointer bumps out of large chunks; there is no per-object free.
+ * Instead the whole arena is released at once with arena_destroy().
+ */
+
+struct arena;
+typedef struct arena arena_t;
+
+arena_t *arena_create(void);
+void arena_destroy(arena_t *a);
+
+void *arena_alloc(arena_t *a, size_t size);
+
+/* Grow an allocation; the old block (old_size bytes) is abandoned in place. */
+void *arena_realloc(arena_t *a, void *ptr, size_t old_size, size_t new_size);
+
+char *arena_strdup(arena_t *a, const char *s);
+
+/*
+ * The arena all parse-time allocations draw from: AST nodes, argv arrays and
+ * token strings for the command line currently being parsed. The front end
+ * points this at a fresh arena before each parse; on success the parse cache
+ * takes ownership of arena and tree together, so a cached tree stays valid
+ * until its cache entry is evicted (which destroys the arena in one go).
+ */
+extern arena_t *command_arena;
+
+#endif
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+
+# Benchmark driver for mysh hot paths. check.py gates correctness; this
+# gates performance. Each benchmark runs several repetitions and emits one
+# JSON object per line on stdout, so CI can parse and threshold the numbers:
+#
+#   {"bench": "command_rate", "unit": "commands/sec",
+#    "reps": [...], "min": ..., "median": ..., "mean": ...}
+#
+# Human-readable progress goes to stderr.
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+SHELL = './mysh'
+
+
+def log(msg):
+    print(msg, file=sys.stderr)
+
+
+def report(name, unit, reps):
+    print(json.dumps({
+        'bench': name,
+        'unit': unit,
+        'reps': [round(r, 3) for r in reps],
+        'min': round(min(reps), 3),
+        'median': round(statistics.median(reps), 3),
+        'mean': round(statistics.mean(reps), 3),
+    }), flush=True)
+
+
+def run_quiet(args, stdin=None):
+    subprocess.run(args, stdin=stdin, stdout=subprocess.DEVNULL,
+                   stderr=subprocess.DEVNULL, check=False)
+
+
+def bench_command_rate(reps, n=50):
+    """Commands/sec through the -c path (startup included)."""
+    out = []
+    for _ in range(reps):
+        start = time.perf_counter()
+        for _ in range(n):
+            run_quiet([SHELL, '-c', 'true'])
+        out.append(n / (time.perf_counter() - start))
+    report('command_rate', 'commands/sec', out)
+
+
+def bench_parse_rate(reps, lines=20000):
+    """Lines/sec through the script batch path (parse plus builtin run)."""
+    with tempfile.NamedTemporaryFile('w', suffix='.sh', delete=False) as f:
+        f.write('true\n' * lines)
+        path = f.name
+    try:
+        out = []
+        for _ in range(reps):
+            start = time.perf_counter()
+            run_quiet([SHELL, path])
+            out.append(lines / (time.perf_counter() - start))
+        report('parse_rate', 'lines/sec', out)
+    finally:
+        os.unlink(path)
+
+
+def bench_pipeline_setup(reps, n_invocations=20):
+    """Wall time per pipeline invocation as the stage count grows."""
+    for n_parts in (2, 4, 8, 16, 32):
+        cmd = ' | '.join(['true'] * n_parts)
+        out = []
+        for _ in range(reps):
+            start = time.perf_counter()
+            for _ in range(n_invocations):
+                run_quiet([SHELL, '-c', cmd])
+            out.append((time.perf_counter() - start) / n_invocations * 1000)
+        report('pipeline_setup_%dparts' % n_parts, 'ms/invocation', out)
+
+
+def bench_fork_exec(reps, n=50):
+    """Extra cost of an external command over an in-process builtin."""
+    def timed(cmd):
+        start = time.perf_counter()
+        for _ in range(n):
+            run_quiet([SHELL, '-c', cmd])
+        return (time.perf_counter() - start) / n * 1000
+
+    out = []
+    for _ in range(reps):
+        out.append(timed('/bin/true') - timed('true'))
+    report('fork_exec_overhead', 'ms/command', out)
+
+
+def bench_startup(reps):
+    """Time from spawn to the first interactive prompt."""
+    import pexpect
+    out = []
+    for _ in range(reps):
+        start = time.perf_counter()
+        shell = pexpect.spawn(SHELL, timeout=10)
+        shell.expect(r'\$ ')
+        out.append((time.perf_counter() - start) * 1000)
+        shell.sendline('exit')
+        shell.wait()
+    report('startup_to_prompt', 'ms', out)
+
+
+BENCHES = {
+    'command_rate': bench_command_rate,
+    'parse_rate': bench_parse_rate,
+    'pipeline_setup': bench_pipeline_setup,
+    'fork_exec': bench_fork_exec,
+    'startup': bench_startup,
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='mysh benchmark suite')
+    parser.add_argument('benches', nargs='*', metavar='BENCH',
+                        help='benchmarks to run (default: all): %s'
+                             % ' '.join(BENCHES))
+    parser.add_argument('-r', '--reps', type=int, default=5,
+                        help='repetitions per benchmark (default: 5)')
+    args = parser.parse_args()
+
+    if not os.path.exists(SHELL):
+        log('%s not built; run make first' % SHELL)
+        return 1
+
+    for name in args.benches:
+        if name not in BENCHES:
+            parser.error('unknown benchmark %r' % name)
+
+    for name in args.benches or BENCHES:
+        log('running %s ...' % name)
+        BENCHES[name](args.reps)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
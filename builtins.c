@@ -0,0 +1,416 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "builtins.h"
+#include "jobs.h"
+
+#define BUILTIN_BUCKETS 64 /* power of two */
+
+struct builtin_entry {
+    struct builtin b;
+    struct builtin_entry *next;
+};
+
+static struct builtin_entry *buckets[BUILTIN_BUCKETS];
+
+/* FNV-1a; plenty for a handful of short command names. */
+static unsigned long hash_name(const char *s)
+{
+    unsigned long h = 2166136261ul;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619ul;
+    }
+    return h;
+}
+
+void builtin_register(const char *name, builtin_fn fn, int flags)
+{
+    struct builtin_entry *e = malloc(sizeof(*e));
+    e->b.name = name;
+    e->b.fn = fn;
+    e->b.flags = flags;
+
+    struct builtin_entry **head = &buckets[hash_name(name) % BUILTIN_BUCKETS];
+    e->next = *head;
+    *head = e;
+}
+
+const struct builtin *builtin_lookup(const char *name)
+{
+    struct builtin_entry *e = buckets[hash_name(name) % BUILTIN_BUCKETS];
+    for (; e; e = e->next)
+        if (strcmp(e->b.name, name) == 0)
+            return &e->b;
+    return NULL;
+}
+
+static int builtin_exit(int argc, char **argv)
+{
+    int exit_code = 0;
+
+    // Check for an exit code argument
+    if (argc > 1) {
+        exit_code = atoi(argv[1]);
+    }
+
+    exit(exit_code);
+}
+
+static int builtin_cd(int argc, char **argv)
+{
+    char *path;
+
+    // Get target directory
+    if (argc < 2) {
+        path = getenv("HOME");
+        if (path == NULL) {
+            fprintf(stderr, "cd: HOME not set\n");
+            return 1;
+        }
+    }
+    else {
+        path = argv[1];
+    }
+
+    if (chdir(path) < 0) {
+        perror("cd");
+        return 1;
+    }
+
+    // Keep PWD in sync for children (and pwd -L), like other shells do
+    char buf[4096];
+    if (getcwd(buf, sizeof(buf)) != NULL)
+        setenv("PWD", buf, 1);
+
+    return 0;
+}
+
+static int builtin_true(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+static int builtin_false(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    return 1;
+}
+
+static int builtin_echo(int argc, char **argv)
+{
+    int i = 1;
+    int newline = 1;
+
+    // Leading flags, bash style: only combinations of n (no newline)
+    for (; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+        const char *p = argv[i] + 1;
+        while (*p == 'n')
+            p++;
+        if (*p != '\0')
+            break; // not a flag after all, echo it
+        newline = 0;
+    }
+
+    for (int first = 1; i < argc; i++, first = 0) {
+        if (!first)
+            putchar(' ');
+        fputs(argv[i], stdout);
+    }
+
+    if (newline)
+        putchar('\n');
+    return 0;
+}
+
+static int builtin_pwd(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    char buf[4096];
+    if (getcwd(buf, sizeof(buf)) == NULL) {
+        perror("pwd");
+        return 1;
+    }
+    puts(buf);
+    return 0;
+}
+
+static int test_file_check(char op, const char *path)
+{
+    struct stat st;
+
+    if (op == 'h' || op == 'L') {
+        if (lstat(path, &st) < 0)
+            return 1;
+        return S_ISLNK(st.st_mode) ? 0 : 1;
+    }
+
+    if (op == 'r')
+        return access(path, R_OK) == 0 ? 0 : 1;
+    if (op == 'w')
+        return access(path, W_OK) == 0 ? 0 : 1;
+    if (op == 'x')
+        return access(path, X_OK) == 0 ? 0 : 1;
+
+    if (stat(path, &st) < 0)
+        return 1;
+
+    switch (op) {
+    case 'e': return 0;
+    case 'f': return S_ISREG(st.st_mode) ? 0 : 1;
+    case 'd': return S_ISDIR(st.st_mode) ? 0 : 1;
+    case 'b': return S_ISBLK(st.st_mode) ? 0 : 1;
+    case 'c': return S_ISCHR(st.st_mode) ? 0 : 1;
+    case 'p': return S_ISFIFO(st.st_mode) ? 0 : 1;
+    case 'S': return S_ISSOCK(st.st_mode) ? 0 : 1;
+    case 's': return st.st_size > 0 ? 0 : 1;
+    }
+    return 2;
+}
+
+/*
+ * POSIX test(1), the common subset: unary string/file operators, string
+ * comparison, integer comparison and a leading '!'. Returns 0 for true,
+ * 1 for false, 2 on usage errors, like the real thing.
+ */
+static int builtin_test(int argc, char **argv)
+{
+    int negate = 0;
+
+    argv++;
+    argc--;
+
+    if (argc > 0 && strcmp(argv[0], "!") == 0) {
+        negate = 1;
+        argv++;
+        argc--;
+    }
+
+    int r;
+    if (argc == 0) {
+        r = 1;
+    }
+    else if (argc == 1) {
+        r = argv[0][0] != '\0' ? 0 : 1;
+    }
+    else if (argc == 2 && argv[0][0] == '-' && argv[0][2] == '\0') {
+        char op = argv[0][1];
+        if (op == 'n')
+            r = argv[1][0] != '\0' ? 0 : 1;
+        else if (op == 'z')
+            r = argv[1][0] == '\0' ? 0 : 1;
+        else
+            r = test_file_check(op, argv[1]);
+    }
+    else if (argc == 3 && strcmp(argv[1], "=") == 0) {
+        r = strcmp(argv[0], argv[2]) == 0 ? 0 : 1;
+    }
+    else if (argc == 3 && strcmp(argv[1], "!=") == 0) {
+        r = strcmp(argv[0], argv[2]) != 0 ? 0 : 1;
+    }
+    else if (argc == 3 && argv[1][0] == '-') {
+        long a = atol(argv[0]), b = atol(argv[2]);
+        const char *op = argv[1] + 1;
+        if      (strcmp(op, "eq") == 0) r = a == b ? 0 : 1;
+        else if (strcmp(op, "ne") == 0) r = a != b ? 0 : 1;
+        else if (strcmp(op, "lt") == 0) r = a <  b ? 0 : 1;
+        else if (strcmp(op, "le") == 0) r = a <= b ? 0 : 1;
+        else if (strcmp(op, "gt") == 0) r = a >  b ? 0 : 1;
+        else if (strcmp(op, "ge") == 0) r = a >= b ? 0 : 1;
+        else r = 2;
+    }
+    else {
+        r = 2;
+    }
+
+    if (r == 2) {
+        fprintf(stderr, "test: invalid expression\n");
+        return 2;
+    }
+    return negate ? !r : r;
+}
+
+/*
+ * Move every byte from in to out. When the kernel supports it the data
+ * never passes through userspace: splice covers the pipe cases (`cat`
+ * between pipeline stages), sendfile the file-to-file/pipe cases
+ * (`cat` under a redirection); a plain read/write loop remains as the
+ * fallback for everything else (e.g. a terminal on either side).
+ */
+static int copy_fd(int in, int out)
+{
+    while (1) {
+        ssize_t n = splice(in, NULL, out, NULL, 1 << 20, SPLICE_F_MOVE);
+        if (n == 0)
+            return 0;
+        if (n < 0) {
+            if (errno == EINVAL)
+                break; // neither side is a pipe; try sendfile
+            return -1;
+        }
+    }
+
+    while (1) {
+        ssize_t n = sendfile(out, in, NULL, 1 << 20);
+        if (n == 0)
+            return 0;
+        if (n < 0) {
+            if (errno == EINVAL || errno == ENOSYS)
+                break; // not supported for this fd pair either
+            return -1;
+        }
+    }
+
+    char buf[64 * 1024];
+    while (1) {
+        ssize_t n = read(in, buf, sizeof(buf));
+        if (n == 0)
+            return 0;
+        if (n < 0)
+            return -1;
+
+        for (ssize_t off = 0; off < n; ) {
+            ssize_t w = write(out, buf + off, n - off);
+            if (w < 0)
+                return -1;
+            off += w;
+        }
+    }
+}
+
+static int builtin_cat(int argc, char **argv)
+{
+    int r = 0;
+
+    // Flags mean formatting work; leave those invocations to the real cat
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            pid_t pid = fork();
+            if (pid < 0) {
+                perror("fork");
+                return 1;
+            }
+            if (pid == 0) {
+                execvp("cat", argv);
+                perror("cat");
+                exit(1);
+            }
+            int status;
+            waitpid(pid, &status, 0);
+            return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+        }
+    }
+
+    if (argc < 2) {
+        if (copy_fd(STDIN_FILENO, STDOUT_FILENO) < 0) {
+            perror("cat");
+            r = 1;
+        }
+        return r;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        int fd;
+
+        if (strcmp(argv[i], "-") == 0)
+            fd = STDIN_FILENO;
+        else
+            fd = open(argv[i], O_RDONLY);
+
+        if (fd < 0) {
+            fprintf(stderr, "cat: %s: %s\n", argv[i], strerror(errno));
+            r = 1;
+            continue;
+        }
+
+        if (copy_fd(fd, STDOUT_FILENO) < 0) {
+            fprintf(stderr, "cat: %s: %s\n", argv[i], strerror(errno));
+            r = 1;
+        }
+
+        if (fd != STDIN_FILENO)
+            close(fd);
+    }
+
+    return r;
+}
+
+/*
+ * `time cmd args...`: run cmd and report real/user/sys on stderr, with the
+ * cpu numbers taken from wait4's rusage. The timed command may itself be a
+ * builtin; it runs in the forked child either way so the accounting covers
+ * exactly it. (The grammar treats `time` as a word, so it can only prefix
+ * a plain command; per-stage pipeline timing is MYSH_PIPE_RUSAGE in
+ * execute_pipe.)
+ */
+static int builtin_time(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "time: missing command\n");
+        return 1;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (pid == 0) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGQUIT, SIG_DFL);
+        signal(SIGTSTP, SIG_DFL);
+
+        const struct builtin *b = builtin_lookup(argv[1]);
+        if (b)
+            exit(b->fn(argc - 1, argv + 1));
+
+        execvp(argv[1], argv + 1);
+        perror(argv[1]);
+        exit(1);
+    }
+
+    struct rusage ru;
+    int status;
+    wait4(pid, &status, 0, &ru);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double real = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    fprintf(stderr, "real\t%.3fs\nuser\t%.3fs\nsys\t%.3fs\n",
+            real,
+            ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6,
+            ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6);
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+void builtins_init(void)
+{
+    builtin_register("exit", builtin_exit, BUILTIN_MUTATES_SHELL);
+    builtin_register("cd", builtin_cd, BUILTIN_MUTATES_SHELL);
+    builtin_register("true", builtin_true, 0);
+    builtin_register("false", builtin_false, 0);
+    builtin_register("echo", builtin_echo, 0);
+    builtin_register("pwd", builtin_pwd, 0);
+    builtin_register("test", builtin_test, 0);
+    builtin_register("jobs", builtin_jobs, BUILTIN_MUTATES_SHELL);
+    builtin_register("cat", builtin_cat, 0);
+    builtin_register("time", builtin_time, 0);
+}
@@ -0,0 +1,33 @@
+#ifndef SHELL_BUILTINS_H
+#define SHELL_BUILTINS_H
+
+/*
+ * Registry of built-in commands. Builtins are registered once at startup and
+ * looked up by name through a hash table, so dispatch stays O(1) as builtins
+ * are added; a new builtin is one builtin_register() call.
+ */
+
+/* The builtin changes shell-process state (cwd, exit, ...). Such builtins
+ * only have their intended effect when run in the shell itself; inside a
+ * pipeline they run in the forked child, like other shells do. */
+#define BUILTIN_MUTATES_SHELL 0x1
+
+typedef int (*builtin_fn)(int argc, char **argv);
+
+struct builtin {
+    const char *name;
+    builtin_fn fn;
+    int flags;
+};
+
+/*
+ * Called once at startup to register the standard builtins.
+ */
+void builtins_init(void);
+
+void builtin_register(const char *name, builtin_fn fn, int flags);
+
+/* Returns NULL if name is not a builtin. */
+const struct builtin *builtin_lookup(const char *name);
+
+#endif
@@ -0,0 +1,266 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "daemon.h"
+#include "jobs.h"
+
+/*
+ * Grab a copy of fd out of the low descriptor range (same discipline as the
+ * redirect code in shell.c), so a client descriptor can take its place for
+ * the duration of one command.
+ */
+static int save_fd(int fd)
+{
+    return fcntl(fd, F_DUPFD_CLOEXEC, 10);
+}
+
+static int make_listener(const char *path)
+{
+    struct sockaddr_un addr;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    unlink(path); /* replace a stale socket from a previous run */
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(fd, 64) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * Receive one request: the first chunk carries the client's stdio via
+ * SCM_RIGHTS, the command string runs until the client shuts down its write
+ * side. Returns the malloc'd NUL-terminated command (or NULL on error) and
+ * fills fds[3]/nfds with whatever descriptors arrived.
+ */
+static char *recv_request(int conn, int fds[3], int *nfds)
+{
+    char *buf = NULL;
+    size_t len = 0, cap = 0;
+    int first = 1;
+
+    *nfds = 0;
+
+    while (1) {
+        if (len + 4096 + 1 > cap) {
+            cap = cap ? cap * 2 : 8192;
+            buf = realloc(buf, cap);
+        }
+
+        ssize_t n;
+        if (first) {
+            struct iovec iov = { buf + len, 4096 };
+            union {
+                struct cmsghdr align;
+                char data[CMSG_SPACE(3 * sizeof(int))];
+            } cbuf;
+            struct msghdr msg;
+
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = cbuf.data;
+            msg.msg_controllen = sizeof(cbuf.data);
+
+            n = recvmsg(conn, &msg, MSG_CMSG_CLOEXEC);
+            if (n >= 0) {
+                struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+                if (c && c->cmsg_level == SOL_SOCKET &&
+                    c->cmsg_type == SCM_RIGHTS) {
+                    size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                    if (count > 3)
+                        count = 3;
+                    memcpy(fds, CMSG_DATA(c), count * sizeof(int));
+                    *nfds = count;
+                }
+                first = 0;
+            }
+        } else {
+            n = recv(conn, buf + len, 4096, 0);
+        }
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            free(buf);
+            return NULL;
+        }
+        if (n == 0)
+            break;
+        len += n;
+    }
+
+    buf[len] = '\0';
+    return buf;
+}
+
+int daemon_serve(const char *path, void (*run)(const char *cmd))
+{
+    int lfd = make_listener(path);
+    if (lfd < 0) {
+        perror(path);
+        return 1;
+    }
+
+    /* A client that vanishes mid-command must not take the daemon down. */
+    signal(SIGPIPE, SIG_IGN);
+
+    while (1) {
+        int conn = accept4(lfd, NULL, NULL, SOCK_CLOEXEC);
+        if (conn < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("accept");
+            break;
+        }
+
+        /* Collect any finished background jobs; never blocks. */
+        jobs_reap();
+
+        int fds[3], nfds;
+        char *cmd = recv_request(conn, fds, &nfds);
+        if (!cmd) {
+            close(conn);
+            continue;
+        }
+
+        /* Swap the client's stdio in around the command, save/restore
+         * style like a redirection; children then write straight to the
+         * client with no relay. */
+        int saved[3];
+        fflush(stdout);
+        fflush(stderr);
+        if (nfds == 3) {
+            for (int i = 0; i < 3; i++) {
+                saved[i] = save_fd(i);
+                dup2(fds[i], i);
+                close(fds[i]);
+            }
+        } else {
+            for (int i = 0; i < nfds; i++)
+                close(fds[i]);
+        }
+
+        run(cmd);
+
+        fflush(stdout);
+        fflush(stderr);
+        if (nfds == 3) {
+            for (int i = 0; i < 3; i++) {
+                dup2(saved[i], i);
+                close(saved[i]);
+            }
+        }
+
+        /* One status byte tells the client the command has completed. The
+         * shell does not track per-command exit status, so this is 0. */
+        char status = 0;
+        while (write(conn, &status, 1) < 0 && errno == EINTR)
+            ;
+
+        close(conn);
+        free(cmd);
+    }
+
+    close(lfd);
+    unlink(path);
+    return 1;
+}
+
+int daemon_submit(const char *path, const char *cmd)
+{
+    struct sockaddr_un addr;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        perror(path);
+        return 1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror(path);
+        close(fd);
+        return 1;
+    }
+
+    /* First message: the command bytes plus our stdio descriptors. */
+    size_t len = strlen(cmd);
+    struct iovec iov = { (void *)cmd, len };
+    union {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(3 * sizeof(int))];
+    } cbuf;
+    struct msghdr msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf.data;
+    msg.msg_controllen = sizeof(cbuf.data);
+
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(3 * sizeof(int));
+    int stdio_fds[3] = { 0, 1, 2 };
+    memcpy(CMSG_DATA(c), stdio_fds, sizeof(stdio_fds));
+
+    ssize_t n = sendmsg(fd, &msg, 0);
+    if (n < 0) {
+        perror("sendmsg");
+        close(fd);
+        return 1;
+    }
+
+    /* Long commands may not fit the first message; push the rest. */
+    for (size_t off = n; off < len; ) {
+        ssize_t w = send(fd, cmd + off, len - off, 0);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("send");
+            close(fd);
+            return 1;
+        }
+        off += w;
+    }
+
+    shutdown(fd, SHUT_WR);
+
+    /* Wait for the daemon to finish the command. */
+    char status;
+    while ((n = read(fd, &status, 1)) < 0 && errno == EINTR)
+        ;
+    close(fd);
+    return n == 1 ? status : 1;
+}
@@ -0,0 +1,27 @@
+#ifndef SHELL_DAEMON_H
+#define SHELL_DAEMON_H
+
+/*
+ * Daemon mode: one warm mysh process serves command lines submitted over a
+ * unix socket, so repeated `mysh -c CMD` invocations stop paying process
+ * startup for every command. The client passes its stdin/stdout/stderr
+ * descriptors along with the command (SCM_RIGHTS), so command output goes
+ * straight to the client's terminal or pipes with no relaying in between;
+ * a single status byte comes back when the command has finished.
+ */
+
+/*
+ * Serve commands on a unix socket at path, calling run() for each submitted
+ * command line with the client's stdio swapped in. Replaces a stale socket
+ * from a previous run. Only returns on error.
+ */
+int daemon_serve(const char *path, void (*run)(const char *cmd));
+
+/*
+ * Submit one command line to the daemon listening at path and wait for it
+ * to finish. Returns the daemon's status byte, or 1 if the daemon cannot
+ * be reached.
+ */
+int daemon_submit(const char *path, const char *cmd);
+
+#endif
@@ -0,0 +1,201 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include "globcache.h"
+#include "arena.h"
+
+#define GLOB_BUCKETS 64 /* power of two */
+
+int glob_attempted = 0;
+
+/*
+ * One cached directory listing: the sorted entry names, and the mtime
+ * they were read at. A lookup whose stat() mtime still matches reuses the
+ * listing; otherwise it is re-read in place. Entries are never removed --
+ * a shell touches few distinct directories over its lifetime.
+ */
+struct dir_listing {
+    char *dir; /* malloc'd key, always an absolute path */
+    struct timespec mtime;
+    char **names; /* malloc'd, sorted */
+    size_t count;
+    struct dir_listing *next;
+};
+
+static struct dir_listing *buckets[GLOB_BUCKETS];
+
+/* FNV-1a, same as the builtin table. */
+static unsigned long hash_dir(const char *s)
+{
+    unsigned long h = 2166136261ul;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619ul;
+    }
+    return h;
+}
+
+static int cmp_name(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void drop_names(struct dir_listing *e)
+{
+    for (size_t i = 0; i < e->count; i++)
+        free(e->names[i]);
+    free(e->names);
+    e->names = NULL;
+    e->count = 0;
+}
+
+static struct dir_listing *dir_listing(const char *dir)
+{
+    struct stat st;
+    if (stat(dir, &st) < 0)
+        return NULL;
+
+    /* A relative directory ("." above all) names a different place after
+     * every cd, so the cache key is always the absolute path. */
+    char keybuf[4096];
+    const char *key = dir;
+    if (dir[0] != '/') {
+        char cwd[4096];
+        if (getcwd(cwd, sizeof(cwd)) == NULL)
+            return NULL;
+        if (strcmp(dir, ".") == 0)
+            key = strcpy(keybuf, cwd);
+        else {
+            if ((size_t)snprintf(keybuf, sizeof(keybuf), "%s/%s",
+                                 cwd, dir) >= sizeof(keybuf))
+                return NULL;
+            key = keybuf;
+        }
+    }
+
+    struct dir_listing **head = &buckets[hash_dir(key) & (GLOB_BUCKETS - 1)];
+    struct dir_listing *e;
+    for (e = *head; e; e = e->next)
+        if (strcmp(e->dir, key) == 0)
+            break;
+
+    /* Nanosecond mtime, so a change within the same second still misses. */
+    if (e && e->mtime.tv_sec == st.st_mtim.tv_sec &&
+        e->mtime.tv_nsec == st.st_mtim.tv_nsec)
+        return e;
+
+    if (!e) {
+        e = malloc(sizeof(*e));
+        e->dir = strdup(key);
+        e->names = NULL;
+        e->count = 0;
+        e->next = *head;
+        *head = e;
+    } else {
+        drop_names(e);
+    }
+    e->mtime = st.st_mtim;
+
+    DIR *d = opendir(dir);
+    if (!d)
+        return e; /* unreadable: cache it as empty until the mtime moves */
+
+    size_t cap = 32;
+    e->names = malloc(cap * sizeof(char *));
+    struct dirent *de;
+    while ((de = readdir(d)) != NULL) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0)
+            continue;
+        if (e->count == cap) {
+            cap *= 2;
+            e->names = realloc(e->names, cap * sizeof(char *));
+        }
+        e->names[e->count++] = strdup(de->d_name);
+    }
+    closedir(d);
+
+    qsort(e->names, e->count, sizeof(char *), cmp_name);
+    return e;
+}
+
+int glob_has_magic(const char *s)
+{
+    /* '[' never survives the lexer, so classes cannot occur here. */
+    return strpbrk(s, "*?") != NULL;
+}
+
+char **glob_expand(const char *pattern, size_t *count)
+{
+    glob_attempted = 1;
+
+    const char *slash = strrchr(pattern, '/');
+
+    /* A wildcard in a parent component means walking several directories;
+     * glob(3) already does that (and sorts), so let it. */
+    if (slash && strpbrk(pattern, "*?") < slash) {
+        glob_t g;
+        if (glob(pattern, 0, NULL, &g) != 0)
+            return NULL;
+        char **out = arena_alloc(command_arena,
+                                 (g.gl_pathc + 1) * sizeof(char *));
+        for (size_t i = 0; i < g.gl_pathc; i++) {
+            size_t l = strlen(g.gl_pathv[i]) + 1;
+            out[i] = arena_alloc(command_arena, l);
+            memcpy(out[i], g.gl_pathv[i], l);
+        }
+        out[g.gl_pathc] = NULL;
+        *count = g.gl_pathc;
+        globfree(&g);
+        return out;
+    }
+
+    const char *leaf = slash ? slash + 1 : pattern;
+    char dir[4096];
+    if (!slash)
+        strcpy(dir, ".");
+    else if (slash == pattern)
+        strcpy(dir, "/");
+    else {
+        size_t dlen = slash - pattern;
+        if (dlen >= sizeof(dir))
+            return NULL;
+        memcpy(dir, pattern, dlen);
+        dir[dlen] = '\0';
+    }
+
+    struct dir_listing *e = dir_listing(dir);
+    if (!e)
+        return NULL;
+
+    /* FNM_PERIOD keeps dotfiles out of '*', like other shells. */
+    size_t n = 0;
+    for (size_t i = 0; i < e->count; i++)
+        if (fnmatch(leaf, e->names[i], FNM_PERIOD) == 0)
+            n++;
+    if (n == 0)
+        return NULL;
+
+    /* Prefix each match with the pattern's directory part verbatim; the
+     * names are already sorted, so the matches come out sorted too. */
+    size_t plen = slash ? (size_t)(slash - pattern) + 1 : 0;
+    char **out = arena_alloc(command_arena, (n + 1) * sizeof(char *));
+    size_t k = 0;
+    for (size_t i = 0; i < e->count; i++) {
+        if (fnmatch(leaf, e->names[i], FNM_PERIOD) != 0)
+            continue;
+        size_t nl = strlen(e->names[i]);
+        char *s = arena_alloc(command_arena, plen + nl + 1);
+        memcpy(s, pattern, plen);
+        memcpy(s + plen, e->names[i], nl + 1);
+        out[k++] = s;
+    }
+    out[n] = NULL;
+    *count = n;
+    return out;
+}
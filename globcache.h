@@ -0,0 +1,34 @@
+#ifndef SHELL_GLOBCACHE_H
+#define SHELL_GLOBCACHE_H
+
+#include <stddef.h>
+
+/*
+ * Wildcard expansion for argv words, backed by a per-directory listing
+ * cache: each directory's sorted entry list is kept in memory and only
+ * re-read when the directory's mtime changes, so a loop that expands the
+ * same pattern over and over hits memory instead of re-reading the
+ * directory every time. Patterns with a wildcard in a parent path
+ * component fall back to glob(3) instead of growing the cache logic for
+ * the rare case.
+ */
+
+/* True when s contains a wildcard the lexer lets through ('*' or '?'). */
+int glob_has_magic(const char *s);
+
+/*
+ * Expand pattern against the filesystem. Returns a sorted NULL-terminated
+ * array of matches allocated from command_arena, storing the match count
+ * in *count, or NULL when nothing matches (the caller then keeps the
+ * pattern literally, like bash without nullglob).
+ */
+char **glob_expand(const char *pattern, size_t *count);
+
+/*
+ * Set whenever an expansion was attempted during the current parse. The
+ * front end uses it to keep such lines out of the parse cache, which
+ * would otherwise replay a frozen expansion result.
+ */
+extern int glob_attempted;
+
+#endif
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "jobs.h"
+#include "reap.h"
+
+struct job {
+    int id;
+    pid_t pid;
+    char *cmd;
+    struct job *next;
+};
+
+static struct job *jobs = NULL;
+static int next_job_id = 1;
+
+/* Set by the SIGCHLD handler; tells jobs_reap there is something to do. */
+static volatile sig_atomic_t sigchld_seen = 0;
+
+static void sigchld_handler(int sig)
+{
+    (void)sig;
+    sigchld_seen = 1;
+}
+
+void jobs_init(void)
+{
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = sigchld_handler;
+    /* SA_RESTART so readline's reads are not interrupted mid-prompt. */
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGCHLD, &sa, NULL);
+}
+
+/* Render a compact one-line description of a command tree into buf. */
+static size_t describe(char *buf, size_t size, node_t *n)
+{
+    size_t len = 0;
+
+#define APPEND(...) do { \
+        if (len < size) \
+            len += snprintf(buf + len, size - len, __VA_ARGS__); \
+    } while (0)
+
+    if (!n)
+        return 0;
+
+    switch (n->type) {
+    case NODE_COMMAND:
+        for (size_t i = 0; i < n->command.argc; i++)
+            APPEND("%s%s", i ? " " : "", n->command.argv[i]);
+        break;
+
+    case NODE_PIPE:
+        for (size_t i = 0; i < n->pipe.n_parts; i++) {
+            if (i)
+                APPEND(" | ");
+            len += describe(buf + len, len < size ? size - len : 0,
+                            n->pipe.parts[i]);
+        }
+        break;
+
+    case NODE_SEQUENCE:
+        for (size_t i = 0; i < n->sequence.n_parts; i++) {
+            if (i)
+                APPEND("; ");
+            len += describe(buf + len, len < size ? size - len : 0,
+                            n->sequence.parts[i]);
+        }
+        break;
+
+    case NODE_REDIRECT:
+        len += describe(buf + len, size - len, n->redirect.child);
+        switch (n->redirect.mode) {
+        case REDIRECT_INPUT:  APPEND(" <%s", n->redirect.target); break;
+        case REDIRECT_OUTPUT: APPEND(" >%s", n->redirect.target); break;
+        case REDIRECT_APPEND: APPEND(" >>%s", n->redirect.target); break;
+        case REDIRECT_DUP:    APPEND(" >&%d", n->redirect.fd2); break;
+        }
+        break;
+
+    case NODE_SUBSHELL:
+        APPEND("( ");
+        len += describe(buf + len, len < size ? size - len : 0,
+                        n->subshell.child);
+        APPEND(" )");
+        break;
+
+    case NODE_DETACH:
+        len += describe(buf + len, size - len, n->detach.child);
+        APPEND(" &");
+        break;
+    }
+
+#undef APPEND
+    return len;
+}
+
+void jobs_add(pid_t pid, node_t *node)
+{
+    struct job *j = malloc(sizeof(*j));
+    char buf[256];
+
+    buf[0] = '\0';
+    describe(buf, sizeof(buf), node);
+
+    j->id = next_job_id++;
+    j->pid = pid;
+    j->cmd = strdup(buf);
+    j->next = jobs;
+    jobs = j;
+}
+
+void jobs_reap(void)
+{
+    if (!sigchld_seen)
+        return;
+    sigchld_seen = 0;
+
+    /* Pipeline stragglers parked by an early return exit too. */
+    reap_poll();
+
+    struct job **pp = &jobs;
+    while (*pp) {
+        struct job *j = *pp;
+        /* Only poll our own recorded pids; a foreground waitpid elsewhere
+         * is never raced for its child. */
+        if (waitpid(j->pid, NULL, WNOHANG) > 0) {
+            *pp = j->next;
+            free(j->cmd);
+            free(j);
+        } else {
+            pp = &j->next;
+        }
+    }
+
+    if (!jobs)
+        next_job_id = 1;
+}
+
+int builtin_jobs(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    jobs_reap();
+    for (struct job *j = jobs; j; j = j->next)
+        printf("[%d] %d %s &\n", j->id, (int)j->pid, j->cmd);
+    return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef SHELL_JOBS_H
+#define SHELL_JOBS_H
+
+#include <sys/types.h>
+#include "parser/ast.h"
+
+/*
+ * Table of detached (`&`) jobs. Children are recorded when they start and
+ * reaped asynchronously: SIGCHLD marks the table dirty and jobs_reap() then
+ * collects finished jobs with waitpid(WNOHANG), so the interactive loop
+ * never blocks on a background command.
+ */
+
+/* Called once at startup; installs the SIGCHLD handler. */
+void jobs_init(void);
+
+/* Record a started background child; node is used for the description. */
+void jobs_add(pid_t pid, node_t *node);
+
+/* Collect finished background jobs without blocking. */
+void jobs_reap(void);
+
+/* The `jobs` builtin: list background jobs still running. */
+int builtin_jobs(int argc, char **argv);
+
+#endif
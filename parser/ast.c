@@ -1,4 +1,6 @@
 #include "ast.h"
+#include "../arena.h"
+#include "../globcache.h"
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -7,7 +9,7 @@
 
 node_t *make_redir(node_t *child, int fd, int mode, int fd2, char *target)
 {
-    node_t *n = malloc(sizeof(node_t));
+    node_t *n = arena_alloc(command_arena, sizeof(node_t));
     n->type = NODE_REDIRECT;
     n->redirect.child = child;
     n->redirect.fd = fd;
@@ -21,35 +23,114 @@ node_t *make_redir(node_t *child, int fd, int mode, int fd2, char *target)
     return n;
 }
 
-node_t *make_simple(char *prog)
+#define ARGV_INLINE \
+    (sizeof(((node_t *)0)->command.argv_inline) / sizeof(char *))
+
+/* Append one pointer, doubling the array when the NULL slot is hit. */
+static void push_arg(node_t *cmd, char *arg)
 {
-    node_t *n = malloc(sizeof(node_t));
+    size_t cap = cmd->command.argv_cap;
+    if (cmd->command.argc + 1 >= cap) {
+        cmd->command.argv = arena_realloc(command_arena, cmd->command.argv,
+                                          sizeof(char *) * cap,
+                                          sizeof(char *) * cap * 2);
+        cmd->command.argv_cap = cap * 2;
+    }
+    cmd->command.argv[cmd->command.argc] = arg;
+    cmd->command.argv[cmd->command.argc + 1] = NULL;
+    cmd->command.argc++;
+}
+
+node_t *make_simple(char *prog, int quoted)
+{
+    node_t *n = arena_alloc(command_arena, sizeof(node_t));
     n->type = NODE_COMMAND;
+
+    if (!quoted && glob_has_magic(prog)) {
+        size_t count;
+        char **matches = glob_expand(prog, &count);
+        if (matches) {
+            n->command.argv = matches;
+            n->command.argc = count;
+            n->command.argv_cap = count + 1; /* exactly full */
+            n->command.program = matches[0];
+            return n;
+        }
+    }
+
     n->command.program = prog;
-    n->command.argv = malloc(2 * sizeof(char *));
-    n->command.argv[0] = strdup(prog);
+    n->command.argv = arena_alloc(command_arena, ARGV_INLINE * sizeof(char *));
+    n->command.argv[0] = prog; /* token text is arena-owned; no copy needed */
     n->command.argv[1] = NULL;
     n->command.argc = 1;
+    n->command.argv_cap = ARGV_INLINE;
     return n;
 }
 
-node_t *extend_simple(node_t *cmd, char *extra)
+node_t *extend_simple(node_t *cmd, char *extra, int quoted)
 {
     assert(cmd->type == NODE_COMMAND);
-    cmd->command.argv = realloc(cmd->command.argv,
-                                 sizeof(char *) * (cmd->command.argc + 2));
-    cmd->command.argv[cmd->command.argc] = extra;
-    cmd->command.argv[cmd->command.argc + 1] = NULL;
-    cmd->command.argc++;
+
+    if (!quoted && glob_has_magic(extra)) {
+        size_t count;
+        char **matches = glob_expand(extra, &count);
+        if (matches) {
+            for (size_t i = 0; i < count; i++)
+                push_arg(cmd, matches[i]);
+            return cmd;
+        }
+    }
+
+    push_arg(cmd, extra);
+    return cmd;
+}
+
+/*
+ * Pack the finished command into its exec-time layout: the pointer array
+ * immediately followed by the string bytes, in argument order, so execvp
+ * and the argv loops in shell.c touch one run of memory. Vectors that fit
+ * go into the node itself (the strings are already adjacent in the arena
+ * for those, having just been lexed back to back).
+ */
+node_t *freeze_simple(node_t *cmd)
+{
+    assert(cmd->type == NODE_COMMAND);
+    size_t argc = cmd->command.argc;
+    char **old = cmd->command.argv;
+
+    cmd->command.argv_cap = 0;
+
+    if (argc + 1 <= ARGV_INLINE) {
+        memcpy(cmd->command.argv_inline, old, (argc + 1) * sizeof(char *));
+        cmd->command.argv = cmd->command.argv_inline;
+        return cmd;
+    }
+
+    size_t bytes = (argc + 1) * sizeof(char *);
+    for (size_t i = 0; i < argc; i++)
+        bytes += strlen(old[i]) + 1;
+
+    char **nv = arena_alloc(command_arena, bytes);
+    char *p = (char *)(nv + argc + 1);
+    for (size_t i = 0; i < argc; i++) {
+        size_t l = strlen(old[i]) + 1;
+        memcpy(p, old[i], l);
+        nv[i] = p;
+        p += l;
+    }
+    nv[argc] = NULL;
+
+    cmd->command.argv = nv;
+    cmd->command.program = nv[0];
     return cmd;
 }
 
 node_t *make_pipe(node_t *first, node_t *second)
 {
-    node_t *n = malloc(sizeof(node_t));
+    node_t *n = arena_alloc(command_arena, sizeof(node_t));
     n->type = NODE_PIPE;
     n->pipe.n_parts = 2;
-    n->pipe.parts = malloc(2 * sizeof(node_t *));
+    n->pipe.parts = arena_alloc(command_arena, 2 * sizeof(node_t *));
     n->pipe.parts[0] = first;
     n->pipe.parts[1] = second;
     return n;
@@ -58,7 +139,9 @@ node_t *make_pipe(node_t *first, node_t *second)
 node_t *extend_pipe(node_t *n, node_t *extra)
 {
     assert(n->type == NODE_PIPE);
-    n->pipe.parts = realloc(n->pipe.parts, sizeof(node_t *) * (n->pipe.n_parts + 1));
+    n->pipe.parts = arena_realloc(command_arena, n->pipe.parts,
+                                  sizeof(node_t *) * n->pipe.n_parts,
+                                  sizeof(node_t *) * (n->pipe.n_parts + 1));
     n->pipe.parts[n->pipe.n_parts] = extra;
     n->pipe.n_parts++;
     return n;
@@ -66,7 +149,7 @@ node_t *extend_pipe(node_t *n, node_t *extra)
 
 node_t *make_subshell(node_t *child)
 {
-    node_t *n = malloc(sizeof(node_t));
+    node_t *n = arena_alloc(command_arena, sizeof(node_t));
     n->type = NODE_SUBSHELL;
     n->subshell.child = child;
     return n;
@@ -74,7 +157,7 @@ node_t *make_subshell(node_t *child)
 
 node_t *make_detach(node_t *child)
 {
-    node_t *n = malloc(sizeof(node_t));
+    node_t *n = arena_alloc(command_arena, sizeof(node_t));
     n->type = NODE_DETACH;
     n->detach.child = child;
     return n;
@@ -82,10 +165,39 @@ node_t *make_detach(node_t *child)
 
 node_t *make_seq(node_t *left, node_t *right)
 {
-    node_t *n = malloc(sizeof(node_t));
+    node_t *n = arena_alloc(command_arena, sizeof(node_t));
     n->type = NODE_SEQUENCE;
-    n->sequence.first = left;
-    n->sequence.second = right;
+    n->sequence.n_parts = 2;
+    n->sequence.parts = arena_alloc(command_arena, 2 * sizeof(node_t *));
+    n->sequence.parts[0] = left;
+    n->sequence.parts[1] = right;
+    return n;
+}
+
+node_t *extend_seq(node_t *n, node_t *extra)
+{
+    assert(n->type == NODE_SEQUENCE);
+    /*
+     * Sequences can get very long (generated scripts), and arena_realloc
+     * abandons the old block, so grow the array geometrically: capacity
+     * is n_parts rounded up to a power of two, doubling when it is hit.
+     */
+    size_t count = n->sequence.n_parts;
+    if ((count & (count - 1)) == 0)
+        n->sequence.parts = arena_realloc(command_arena, n->sequence.parts,
+                                          sizeof(node_t *) * count,
+                                          sizeof(node_t *) * count * 2);
+    n->sequence.parts[count] = extra;
+    n->sequence.n_parts++;
+    return n;
+}
+
+/* Grammar helper for "a; b & c": the '&' applies to the last part only. */
+node_t *detach_last(node_t *n)
+{
+    assert(n->type == NODE_SEQUENCE);
+    n->sequence.parts[n->sequence.n_parts - 1] =
+        make_detach(n->sequence.parts[n->sequence.n_parts - 1]);
     return n;
 }
 
@@ -174,11 +286,13 @@ void print_tree_flat(node_t *n, int nl)
         break;
 
     case NODE_SEQUENCE:
-        printf(" { ");
-        print_tree_flat(n->sequence.first, 0);
-        printf(" }; { ");
-        print_tree_flat(n->sequence.second, 0);
-        printf(" } ");
+        for (i = 0; i < n->sequence.n_parts; ++i) {
+            if (i > 0)
+                printf("; ");
+            printf(" { ");
+            print_tree_flat(n->sequence.parts[i], 0);
+            printf(" } ");
+        }
         break;
     }
 
@@ -253,8 +367,8 @@ static void print_tree_rec(node_t *n, int ind)
 
     case NODE_SEQUENCE:
         printf("SEQUENCE\n");
-        print_tree_rec(n->sequence.first, ind + 1);
-        print_tree_rec(n->sequence.second, ind + 1);
+        for (i = 0; i < n->sequence.n_parts; ++i)
+            print_tree_rec(n->sequence.parts[i], ind + 1);
         break;
     }
 }
@@ -267,43 +381,10 @@ void print_tree(node_t *node)
 
 void free_tree(node_t *n)
 {
-    size_t i;
-
-    if (!n)
-        return;
-
-    switch(n->type) {
-    case NODE_COMMAND:
-        free(n->command.program);
-        for (i = 0; i < n->command.argc; ++i)
-            free(n->command.argv[i]);
-        free(n->command.argv);
-        break;
-
-    case NODE_PIPE:
-        for (i = 0; i < n->pipe.n_parts; ++i)
-            free_tree(n->pipe.parts[i]);
-        free(n->pipe.parts);
-        break;
-
-    case NODE_REDIRECT:
-        if (n->redirect.mode > 0)
-            free(n->redirect.target);
-        free_tree(n->redirect.child);
-        break;
-
-    case NODE_SUBSHELL:
-        free_tree(n->subshell.child);
-        break;
-
-    case NODE_DETACH:
-        free_tree(n->detach.child);
-        break;
-
-    case NODE_SEQUENCE:
-        free_tree(n->sequence.first);
-        free_tree(n->sequence.second);
-        break;
-    }
-    free(n);
+    /*
+     * Nothing to do per tree: nodes, argv arrays and strings all live in
+     * an arena owned by the front end's parse cache, which destroys it in
+     * one go when the cache entry for the line is evicted.
+     */
+    (void)n;
 }
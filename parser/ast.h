@@ -33,6 +33,9 @@ struct tree_node
             char *program;
             char **argv;
             size_t argc;
+            size_t argv_cap;      /* build-time slots incl. the NULL;
+                                     0 once the node is frozen */
+            char *argv_inline[4]; /* frozen home of small argv arrays */
         } command;
 
         struct {
@@ -59,14 +62,16 @@ struct tree_node
         } detach;
 
         struct {
-            node_t *first;
-            node_t *second;
+            node_t **parts; // array, run in order
+            size_t n_parts;
         } sequence;
     };
 };
 
 /*
- * This function de-allocates a command tree.
+ * This function releases a command tree. Trees are allocated from
+ * command_arena (see arena.h), so this is a no-op; the memory is reclaimed
+ * when the arena holding the tree is destroyed.
  */
 void free_tree(node_t *root);
 
@@ -84,9 +89,24 @@ void print_tree_flat(node_t *root, int print_final_newline);
 
 /* Node constructors */
 node_t *make_detach(node_t *child);
-node_t *make_simple(char *prog);
-node_t *extend_simple(node_t *cmd, char *arg);
+/*
+ * Simple-command constructors. Words with quoted == 0 that contain a
+ * wildcard are glob-expanded (see globcache.h) as they are appended; a
+ * pattern with no matches is kept literally.
+ */
+node_t *make_simple(char *prog, int quoted);
+node_t *extend_simple(node_t *cmd, char *arg, int quoted);
+
+/*
+ * Called when the grammar can no longer extend a simple command: packs
+ * the argv pointer array and its strings into one contiguous block (or
+ * into the node itself when the array is small) so exec walks adjacent
+ * memory instead of chasing build-time allocations.
+ */
+node_t *freeze_simple(node_t *cmd);
 node_t *make_seq(node_t *left, node_t *right);
+node_t *extend_seq(node_t *seq, node_t *extra);
+node_t *detach_last(node_t *seq);
 node_t *make_pipe(node_t *first, node_t *second);
 node_t *extend_pipe(node_t *pipe, node_t *extra);
 node_t *make_subshell(node_t *child);
@@ -486,21 +486,26 @@ char *yytext;
 #line 2 "parser/lexer.l"
 #include "parser.h"
 #include "lexer.h"
+#include "../arena.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <readline/history.h>
 #pragma GCC diagnostic ignored "-Wunused-function"
 #pragma GCC diagnostic ignored "-Wsign-compare"
 
 char *token_text = 0;
+size_t token_len = 0;
+int token_quoted = 0;
 char *string_buf = 0;
 size_t string_buf_len = 0;
 char *string_buf_ptr = 0;
+static void set_token(const char *, size_t);
+static void finish_text(void);
 static void reset_text(void);
-static void extend_text(char *);
+static void extend_text_n(const char *, size_t);
 static void extend_text1(int);
 static void extend_textx(char *);
-static void free_text(void);
 
 #line 506 "parser/lex.yy.c"
 
@@ -845,47 +850,47 @@ case YY_STATE_EOF(INITIAL):
 case 12:
 YY_RULE_SETUP
 #line 45 "parser/lexer.l"
-{ token_text = yytext; return NUMBER; }
+{ set_token(yytext, yyleng); return NUMBER; }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
 #line 47 "parser/lexer.l"
-{ reset_text(); extend_text (yytext);    BEGIN(text); }
+{ reset_text(); extend_text_n(yytext, yyleng);    BEGIN(text); }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
 #line 48 "parser/lexer.l"
-{ reset_text(); extend_textx(yytext+2);  BEGIN(text); }
+{ reset_text(); token_quoted = 1; extend_textx(yytext+2);  BEGIN(text); }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
 #line 49 "parser/lexer.l"
-{ reset_text(); extend_text1(yytext[1]); BEGIN(text); }
+{ reset_text(); token_quoted = 1; extend_text1(yytext[1]); BEGIN(text); }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
 #line 50 "parser/lexer.l"
-{ reset_text(); BEGIN(str); }
+{ reset_text(); token_quoted = 1; BEGIN(str); }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
 #line 52 "parser/lexer.l"
-{ extend_text (yytext); }
+{ extend_text_n(yytext, yyleng); }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
 #line 53 "parser/lexer.l"
-{ extend_textx(yytext + 2); }
+{ token_quoted = 1; extend_textx(yytext + 2); }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
 #line 54 "parser/lexer.l"
-{ extend_text1(yytext[1]); }
+{ token_quoted = 1; extend_text1(yytext[1]); }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
 #line 55 "parser/lexer.l"
-{ BEGIN(str); }
+{ token_quoted = 1; BEGIN(str); }
 	YY_BREAK
 case 21:
 /* rule 21 can match eol */
@@ -895,11 +900,11 @@ YY_LINENO_REWIND_TO(yy_cp - 1);
 YY_DO_BEFORE_ACTION; /* set up yytext again */
 YY_RULE_SETUP
 #line 56 "parser/lexer.l"
-{ extend_text1(0); BEGIN(INITIAL); token_text = string_buf; return WORD; }
+{ finish_text(); BEGIN(INITIAL); return WORD; }
 	YY_BREAK
 case YY_STATE_EOF(text):
 #line 57 "parser/lexer.l"
-{ extend_text1(0); BEGIN(INITIAL); token_text = string_buf; return WORD; }
+{ finish_text(); BEGIN(INITIAL); return WORD; }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
@@ -944,7 +949,7 @@ YY_RULE_SETUP
 case 30:
 YY_RULE_SETUP
 #line 67 "parser/lexer.l"
-{ extend_text (yytext); }
+{ extend_text_n(yytext, yyleng); }
 	YY_BREAK
 case YY_STATE_EOF(str):
 #line 68 "parser/lexer.l"
@@ -1968,33 +1973,71 @@ void yyfree (void * ptr )
 
 
 
+/*
+ * Token text accumulates straight into command_arena, so the finished token
+ * is already in its final storage: the parser and the AST reference it there
+ * without any further copies, and it stays valid until the arena is reset
+ * after the command line completes.
+ */
 static void reset_text(void)
 {
-    if (string_buf_len == 0)
-    {
-        string_buf = malloc(32);
-        string_buf_len = 32;
-        atexit(free_text);
-    }
+    token_quoted = 0; /* set again if any part of the word is quoted/escaped */
+    string_buf_len = 32;
+    string_buf = arena_alloc(command_arena, string_buf_len);
     string_buf_ptr = string_buf;
 }
 
+/* NUL-terminate the accumulated text and publish it as the current token. */
+static void finish_text(void)
+{
+    extend_text1(0);
+    token_text = string_buf;
+    token_len = string_buf_ptr - string_buf - 1;
+}
+
+/* Publish a token copied verbatim from the scan buffer. */
+static void set_token(const char *s, size_t n)
+{
+    token_text = arena_alloc(command_arena, n + 1);
+    memcpy(token_text, s, n);
+    token_text[n] = '\0';
+    token_len = n;
+}
+
 static void extend_text1(int c)
 {
     size_t l = string_buf_ptr - string_buf;
     if (l >= string_buf_len)
     {
+        string_buf = arena_realloc(command_arena, string_buf, string_buf_len,
+                                   string_buf_len * 2);
         string_buf_len *= 2;
-        string_buf = realloc(string_buf, string_buf_len);
+        string_buf_ptr = string_buf + l;
     }
-    string_buf_ptr = string_buf + l;
     *string_buf_ptr++ = c;
 }
 
-static void extend_text(char *s)
+/*
+ * Append a whole run of characters at once. The scanner's DFA already
+ * consumes SIMPLECHAR and quoted-string runs as single matches, so bulk
+ * appends go through one capacity check and one memcpy instead of a
+ * per-character loop, and the buffer doubles until the run fits.
+ */
+static void extend_text_n(const char *s, size_t n)
 {
-    while (*s)
-        extend_text1(*s++);
+    size_t l = string_buf_ptr - string_buf;
+    if (l + n > string_buf_len)
+    {
+        size_t cap = string_buf_len;
+        while (cap < l + n)
+            cap *= 2;
+        string_buf = arena_realloc(command_arena, string_buf,
+                                   string_buf_len, cap);
+        string_buf_len = cap;
+        string_buf_ptr = string_buf + l;
+    }
+    memcpy(string_buf_ptr, s, n);
+    string_buf_ptr += n;
 }
 
 static void extend_textx(char *s)
@@ -2004,11 +2047,6 @@ static void extend_textx(char *s)
     extend_text1(c);
 }
 
-static void free_text(void)
-{
-    free(string_buf);
-}
-
 int yywrap(void)
 {
    return 1;
@@ -3,11 +3,20 @@
 
 #include <stddef.h>
 
+/*
+ * A token's value is a span: a pointer into arena-backed storage that stays
+ * valid until the command line completes, plus its length. The text is also
+ * NUL-terminated so it can be placed in an argv without another copy.
+ */
 struct lex_token {
     char *text;
+    size_t len;
     int number;
+    int quoted; /* any part of the word was quoted/escaped: no expansion */
 };
 extern char *token_text;
+extern size_t token_len;
+extern int token_quoted;
 
 void *ParseAlloc(void * (*)(size_t));
 void ParseFree(void *, void (*)(void *));
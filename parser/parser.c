@@ -13,8 +13,9 @@
 #include <stdlib.h>
 int echo = 0;
 int parse_error = 0;
+node_t *parsed_tree = NULL; /* root of the last accepted parse */
 #pragma GCC diagnostic ignored "-Wunused-parameter"
-#line 18 "parser/parser.c"
+#line 19 "parser/parser.c"
 /* Next is all token values, in a form suitable for use by makeheaders.
 ** This section will be null unless lemon is run with the -m switch.
 */
@@ -65,14 +66,14 @@ int parse_error = 0;
 **                       defined, then do no error processing.
 */
 #define YYCODETYPE unsigned char
-#define YYNOCODE 23
+#define YYNOCODE 24
 #define YYACTIONTYPE unsigned char
 #define ParseTOKENTYPE  struct lex_token 
 typedef union {
   int yyinit;
   ParseTOKENTYPE yy0;
-  node_t * yy20;
-  int yy21;
+  node_t * yy4;
+  int yy6;
 } YYMINORTYPE;
 #ifndef YYSTACKDEPTH
 #define YYSTACKDEPTH 100
@@ -81,8 +82,8 @@ typedef union {
 #define ParseARG_PDECL
 #define ParseARG_FETCH
 #define ParseARG_STORE
-#define YYNSTATE 58
-#define YYNRULE 29
+#define YYNSTATE 63
+#define YYNRULE 34
 #define YY_NO_ACTION      (YYNSTATE+YYNRULE+2)
 #define YY_ACCEPT_ACTION  (YYNSTATE+YYNRULE+1)
 #define YY_ERROR_ACTION   (YYNSTATE+YYNRULE)
@@ -151,60 +152,64 @@ static const YYMINORTYPE yyzerominor = { 0 };
 **                     shifting non-terminals after a reduce.
 **  yy_default[]       Default action for each state.
 */
-#define YY_ACTTAB_COUNT (111)
+#define YY_ACTTAB_COUNT (127)
 static const YYACTIONTYPE yy_action[] = {
- /*     0 */    37,   31,   18,   20,   46,   32,    3,   58,    2,   31,
- /*    10 */    18,   20,   46,   32,    3,   35,    2,   88,   36,   22,
- /*    20 */    34,   28,   55,   19,   59,   57,   22,   34,   28,   55,
- /*    30 */    19,   26,   22,   34,   28,   55,   19,   27,   22,   34,
- /*    40 */    28,   55,   19,   38,   22,   34,   28,   55,   19,   33,
- /*    50 */    23,   14,    6,   29,   25,   56,   10,   55,   19,   54,
- /*    60 */     4,   55,   19,    1,   53,   16,   55,   19,   52,   21,
- /*    70 */    55,   19,   51,   47,   55,   19,   48,    9,   55,   19,
- /*    80 */    44,   30,   55,   19,    7,   43,   15,   55,   19,   42,
- /*    90 */    13,   55,   19,   41,   12,   55,   19,   40,   11,   55,
- /*   100 */    19,   39,   17,   55,   19,   24,   49,   50,   45,    8,
- /*   110 */     5,
+ /*     0 */    98,   39,   25,   21,   37,   31,   60,   22,   40,   34,
+ /*    10 */    20,   23,   50,   35,    2,   63,    1,   34,   20,   23,
+ /*    20 */    50,   35,    2,   38,    1,   29,   25,   21,   37,   31,
+ /*    30 */    60,   22,   64,   30,   25,   21,   37,   31,   60,   22,
+ /*    40 */    62,   18,   37,   31,   60,   22,   53,   16,   37,   31,
+ /*    50 */    60,   22,   49,   17,   37,   31,   60,   22,   41,   24,
+ /*    60 */    37,   31,   60,   22,    6,   36,   26,    3,    8,   48,
+ /*    70 */    32,   28,   61,   12,   60,   22,   59,   33,   60,   22,
+ /*    80 */     9,   58,   19,   60,   22,   27,   57,   15,   60,   22,
+ /*    90 */    56,   14,   60,   22,   52,   51,   60,   22,   47,    5,
+ /*   100 */    60,   22,    4,   46,   13,   60,   22,   11,   45,   99,
+ /*   110 */    60,   22,   44,   10,   60,   22,   43,   99,   60,   22,
+ /*   120 */    42,    7,   60,   22,   99,   54,   55,
 };
 static const YYCODETYPE yy_lookahead[] = {
- /*     0 */     3,    4,    5,    6,    7,    8,    9,    0,   11,    4,
- /*    10 */     5,    6,    7,    8,    9,    3,   11,   15,   16,   17,
- /*    20 */    18,   19,   20,   21,    0,   16,   17,   18,   19,   20,
- /*    30 */    21,   16,   17,   18,   19,   20,   21,   16,   17,   18,
- /*    40 */    19,   20,   21,   16,   17,   18,   19,   20,   21,    4,
- /*    50 */     5,    7,    7,    4,    5,   18,    7,   20,   21,   18,
- /*    60 */     1,   20,   21,    4,   18,    2,   20,   21,   18,    5,
- /*    70 */    20,   21,   18,   12,   20,   21,   18,    7,   20,   21,
- /*    80 */    18,    4,   20,   21,    7,   18,    6,   20,   21,   18,
- /*    90 */     6,   20,   21,   18,    6,   20,   21,   18,    2,   20,
- /*   100 */    21,   18,    5,   20,   21,    8,    6,    7,   10,    7,
- /*   110 */     7,
+ /*     0 */    15,   16,   17,   18,   19,   20,   21,   22,    3,    4,
+ /*    10 */     5,    6,    7,    8,    9,    0,   11,    4,    5,    6,
+ /*    20 */     7,    8,    9,    3,   11,   16,   17,   18,   19,   20,
+ /*    30 */    21,   22,    0,   16,   17,   18,   19,   20,   21,   22,
+ /*    40 */    17,    2,   19,   20,   21,   22,   17,    7,   19,   20,
+ /*    50 */    21,   22,   17,    6,   19,   20,   21,   22,   17,    5,
+ /*    60 */    19,   20,   21,   22,    1,    4,    5,    4,    7,   10,
+ /*    70 */     4,    5,   19,    7,   21,   22,   19,    4,   21,   22,
+ /*    80 */     7,   19,    5,   21,   22,    8,   19,    6,   21,   22,
+ /*    90 */    19,    6,   21,   22,   19,   12,   21,   22,   19,    1,
+ /*   100 */    21,   22,    4,   19,    2,   21,   22,    7,   19,   23,
+ /*   110 */    21,   22,   19,    7,   21,   22,   19,   23,   21,   22,
+ /*   120 */    19,    7,   21,   22,   23,    6,    7,
 };
-#define YY_SHIFT_USE_DFLT (-4)
-#define YY_SHIFT_COUNT (37)
-#define YY_SHIFT_MIN   (-3)
-#define YY_SHIFT_MAX   (103)
+#define YY_SHIFT_USE_DFLT (-1)
+#define YY_SHIFT_COUNT (40)
+#define YY_SHIFT_MIN   (0)
+#define YY_SHIFT_MAX   (119)
 static const signed char yy_shift_ofst[] = {
- /*     0 */    -3,    5,    5,    5,    5,    5,    5,    5,    5,    5,
- /*    10 */     5,    5,    5,    5,    5,    5,    5,   49,   45,  100,
- /*    20 */    97,   77,   59,  103,  102,   70,   98,   61,   96,   88,
- /*    30 */    84,   64,   44,   80,   63,   24,   12,    7,
+ /*     0 */     5,   13,   13,   13,   13,   13,   13,   13,   13,   13,
+ /*    10 */    13,   13,   13,   13,   13,   13,   13,   13,   13,   66,
+ /*    20 */    61,   98,  119,   77,   73,   63,  114,  106,  100,   59,
+ /*    30 */    83,  102,   85,   81,   54,   40,   47,   39,   32,   20,
+ /*    40 */    15,
 };
-#define YY_REDUCE_USE_DFLT (-1)
-#define YY_REDUCE_COUNT (16)
-#define YY_REDUCE_MIN   (0)
-#define YY_REDUCE_MAX   (83)
+#define YY_REDUCE_USE_DFLT (-16)
+#define YY_REDUCE_COUNT (18)
+#define YY_REDUCE_MIN   (-15)
+#define YY_REDUCE_MAX   (101)
 static const signed char yy_reduce_ofst[] = {
- /*     0 */     2,   27,   21,   15,    9,   83,   79,   75,   71,   67,
- /*    10 */    62,   58,   54,   50,   46,   41,   37,
+ /*     0 */   -15,   17,    9,   41,   35,   29,   23,  101,   97,   93,
+ /*    10 */    89,   84,   79,   75,   71,   67,   62,   57,   53,
 };
 static const YYACTIONTYPE yy_default[] = {
- /*     0 */    87,   62,   87,   87,   61,   87,   87,   87,   87,   87,
- /*    10 */    87,   87,   87,   87,   87,   87,   87,   87,   87,   80,
- /*    20 */    84,   87,   60,   87,   87,   87,   87,   87,   66,   87,
- /*    30 */    87,   87,   87,   87,   65,   87,   87,   87,   64,   72,
- /*    40 */    71,   75,   79,   78,   77,   81,   83,   82,   68,   86,
- /*    50 */    85,   76,   74,   73,   70,   69,   67,   63,
+ /*     0 */    97,   97,   97,   67,   70,   69,   66,   97,   97,   97,
+ /*    10 */    97,   97,   97,   97,   97,   97,   97,   97,   97,   97,
+ /*    20 */    97,   68,   90,   94,   97,   65,   97,   97,   97,   97,
+ /*    30 */    97,   76,   97,   97,   97,   97,   97,   75,   97,   97,
+ /*    40 */    97,   72,   82,   81,   85,   89,   88,   87,   91,   74,
+ /*    50 */    93,   92,   78,   73,   96,   95,   86,   84,   83,   80,
+ /*    60 */    79,   77,   71,
 };
 
 /* The next table maps tokens into fallback tokens.  If a construct
@@ -301,8 +306,8 @@ static const char *const yyTokenName[] = {
   "AMP",           "GT",            "NUMBER",        "WORD",        
   "LT",            "BRL",           "BRR",           "PL",          
   "PR",            "error",         "commands",      "top",         
-  "seq",           "pipe",          "redir",         "pipe1",       
-  "group",         "simple",      
+  "seq",           "pipe",          "seq1",          "redir",       
+  "pipe1",         "group",         "simple",      
 };
 #endif /* NDEBUG */
 
@@ -315,30 +320,35 @@ static const char *const yyRuleName[] = {
  /*   2 */ "seq ::= pipe",
  /*   3 */ "seq ::= pipe SEMI",
  /*   4 */ "seq ::= pipe AMP",
- /*   5 */ "seq ::= pipe SEMI seq",
- /*   6 */ "seq ::= pipe AMP seq",
- /*   7 */ "pipe ::= redir",
- /*   8 */ "pipe ::= pipe1",
- /*   9 */ "pipe1 ::= redir PIPE redir",
- /*  10 */ "pipe1 ::= pipe1 PIPE redir",
- /*  11 */ "redir ::= group",
- /*  12 */ "redir ::= GT AMP NUMBER redir",
- /*  13 */ "redir ::= GT WORD redir",
- /*  14 */ "redir ::= GT GT WORD redir",
- /*  15 */ "redir ::= LT WORD redir",
- /*  16 */ "redir ::= AMP GT AMP NUMBER redir",
- /*  17 */ "redir ::= AMP GT WORD redir",
- /*  18 */ "redir ::= NUMBER GT AMP NUMBER redir",
- /*  19 */ "redir ::= NUMBER GT WORD redir",
- /*  20 */ "redir ::= NUMBER GT GT WORD redir",
- /*  21 */ "redir ::= NUMBER LT WORD redir",
- /*  22 */ "group ::= simple",
- /*  23 */ "group ::= BRL seq BRR",
- /*  24 */ "group ::= PL seq PR",
- /*  25 */ "simple ::= WORD",
- /*  26 */ "simple ::= NUMBER",
- /*  27 */ "simple ::= simple WORD",
- /*  28 */ "simple ::= simple NUMBER",
+ /*   5 */ "seq ::= seq1",
+ /*   6 */ "seq ::= seq1 SEMI",
+ /*   7 */ "seq ::= seq1 AMP",
+ /*   8 */ "seq1 ::= pipe SEMI pipe",
+ /*   9 */ "seq1 ::= pipe AMP pipe",
+ /*  10 */ "seq1 ::= seq1 SEMI pipe",
+ /*  11 */ "seq1 ::= seq1 AMP pipe",
+ /*  12 */ "pipe ::= redir",
+ /*  13 */ "pipe ::= pipe1",
+ /*  14 */ "pipe1 ::= redir PIPE redir",
+ /*  15 */ "pipe1 ::= pipe1 PIPE redir",
+ /*  16 */ "redir ::= group",
+ /*  17 */ "redir ::= GT AMP NUMBER redir",
+ /*  18 */ "redir ::= GT WORD redir",
+ /*  19 */ "redir ::= GT GT WORD redir",
+ /*  20 */ "redir ::= LT WORD redir",
+ /*  21 */ "redir ::= AMP GT AMP NUMBER redir",
+ /*  22 */ "redir ::= AMP GT WORD redir",
+ /*  23 */ "redir ::= NUMBER GT AMP NUMBER redir",
+ /*  24 */ "redir ::= NUMBER GT WORD redir",
+ /*  25 */ "redir ::= NUMBER GT GT WORD redir",
+ /*  26 */ "redir ::= NUMBER LT WORD redir",
+ /*  27 */ "group ::= simple",
+ /*  28 */ "group ::= BRL seq BRR",
+ /*  29 */ "group ::= PL seq PR",
+ /*  30 */ "simple ::= WORD",
+ /*  31 */ "simple ::= NUMBER",
+ /*  32 */ "simple ::= simple WORD",
+ /*  33 */ "simple ::= simple NUMBER",
 };
 #endif /* NDEBUG */
 
@@ -432,8 +442,8 @@ static void yy_destructor(
     case 12: /* PR */
 {
 #line 2 "parser/parser.y"
- if ((yypminor->yy0).text) free((yypminor->yy0).text); 
-#line 437 "parser/parser.c"
+ (void)(yypminor->yy0); /* token text is owned by command_arena */ 
+#line 447 "parser/parser.c"
 }
       break;
       /* Default NON-TERMINAL Destructor */
@@ -442,14 +452,15 @@ static void yy_destructor(
     case 15: /* top */
     case 16: /* seq */
     case 17: /* pipe */
-    case 18: /* redir */
-    case 19: /* pipe1 */
-    case 20: /* group */
-    case 21: /* simple */
+    case 18: /* seq1 */
+    case 19: /* redir */
+    case 20: /* pipe1 */
+    case 21: /* group */
+    case 22: /* simple */
 {
 #line 4 "parser/parser.y"
- free_tree((yypminor->yy20)); 
-#line 453 "parser/parser.c"
+ free_tree((yypminor->yy4)); 
+#line 464 "parser/parser.c"
 }
       break;
     default:  break;   /* If no destructor action specified: do nothing */
@@ -692,30 +703,35 @@ static const struct {
   { 16, 1 },
   { 16, 2 },
   { 16, 2 },
-  { 16, 3 },
-  { 16, 3 },
-  { 17, 1 },
-  { 17, 1 },
-  { 19, 3 },
-  { 19, 3 },
-  { 18, 1 },
-  { 18, 4 },
+  { 16, 1 },
+  { 16, 2 },
+  { 16, 2 },
   { 18, 3 },
-  { 18, 4 },
   { 18, 3 },
-  { 18, 5 },
-  { 18, 4 },
-  { 18, 5 },
-  { 18, 4 },
-  { 18, 5 },
-  { 18, 4 },
-  { 20, 1 },
+  { 18, 3 },
+  { 18, 3 },
+  { 17, 1 },
+  { 17, 1 },
   { 20, 3 },
   { 20, 3 },
+  { 19, 1 },
+  { 19, 4 },
+  { 19, 3 },
+  { 19, 4 },
+  { 19, 3 },
+  { 19, 5 },
+  { 19, 4 },
+  { 19, 5 },
+  { 19, 4 },
+  { 19, 5 },
+  { 19, 4 },
   { 21, 1 },
-  { 21, 1 },
-  { 21, 2 },
-  { 21, 2 },
+  { 21, 3 },
+  { 21, 3 },
+  { 22, 1 },
+  { 22, 1 },
+  { 22, 2 },
+  { 22, 2 },
 };
 
 static void yy_accept(yyParser*);  /* Forward Declaration */
@@ -771,158 +787,190 @@ static void yy_reduce(
   **     break;
   */
       case 0: /* top ::= END */
-#line 23 "parser/parser.y"
+#line 24 "parser/parser.y"
 {   yy_destructor(yypParser,3,&yymsp[0].minor);
 }
-#line 778 "parser/parser.c"
+#line 794 "parser/parser.c"
         break;
       case 1: /* top ::= seq END */
-#line 24 "parser/parser.y"
-{ if (parse_error) free_tree(yymsp[-1].minor.yy20);
-                      else { if (echo) print_tree_flat(yymsp[-1].minor.yy20, 1);
-                             run_command(yymsp[-1].minor.yy20);
-                             free_tree(yymsp[-1].minor.yy20);
+#line 25 "parser/parser.y"
+{ if (parse_error) free_tree(yymsp[-1].minor.yy4);
+                      else { parsed_tree = yymsp[-1].minor.yy4; /* retained for the parse cache */
+                             if (echo) print_tree_flat(yymsp[-1].minor.yy4, 1);
+                             run_command(yymsp[-1].minor.yy4);
                            }   yy_destructor(yypParser,3,&yymsp[0].minor);
 }
-#line 788 "parser/parser.c"
+#line 804 "parser/parser.c"
         break;
       case 2: /* seq ::= pipe */
-      case 7: /* pipe ::= redir */ yytestcase(yyruleno==7);
-      case 8: /* pipe ::= pipe1 */ yytestcase(yyruleno==8);
-      case 11: /* redir ::= group */ yytestcase(yyruleno==11);
-      case 22: /* group ::= simple */ yytestcase(yyruleno==22);
-#line 30 "parser/parser.y"
-{ yygotominor.yy20 = yymsp[0].minor.yy20; }
-#line 797 "parser/parser.c"
+      case 5: /* seq ::= seq1 */ yytestcase(yyruleno==5);
+      case 12: /* pipe ::= redir */ yytestcase(yyruleno==12);
+      case 13: /* pipe ::= pipe1 */ yytestcase(yyruleno==13);
+      case 16: /* redir ::= group */ yytestcase(yyruleno==16);
+#line 33 "parser/parser.y"
+{ yygotominor.yy4 = yymsp[0].minor.yy4; }
+#line 813 "parser/parser.c"
         break;
       case 3: /* seq ::= pipe SEMI */
-#line 31 "parser/parser.y"
-{ yygotominor.yy20 = yymsp[-1].minor.yy20;   yy_destructor(yypParser,1,&yymsp[0].minor);
+      case 6: /* seq ::= seq1 SEMI */ yytestcase(yyruleno==6);
+#line 34 "parser/parser.y"
+{ yygotominor.yy4 = yymsp[-1].minor.yy4;   yy_destructor(yypParser,1,&yymsp[0].minor);
 }
-#line 803 "parser/parser.c"
+#line 820 "parser/parser.c"
         break;
       case 4: /* seq ::= pipe AMP */
-#line 32 "parser/parser.y"
-{ yygotominor.yy20 = make_detach(yymsp[-1].minor.yy20);   yy_destructor(yypParser,4,&yymsp[0].minor);
+#line 35 "parser/parser.y"
+{ yygotominor.yy4 = make_detach(yymsp[-1].minor.yy4);   yy_destructor(yypParser,4,&yymsp[0].minor);
 }
-#line 809 "parser/parser.c"
+#line 826 "parser/parser.c"
         break;
-      case 5: /* seq ::= pipe SEMI seq */
-#line 33 "parser/parser.y"
-{ yygotominor.yy20 = make_seq(yymsp[-2].minor.yy20, yymsp[0].minor.yy20);   yy_destructor(yypParser,1,&yymsp[-1].minor);
+      case 7: /* seq ::= seq1 AMP */
+#line 38 "parser/parser.y"
+{ yygotominor.yy4 = detach_last(yymsp[-1].minor.yy4);   yy_destructor(yypParser,4,&yymsp[0].minor);
 }
-#line 815 "parser/parser.c"
+#line 832 "parser/parser.c"
         break;
-      case 6: /* seq ::= pipe AMP seq */
-#line 34 "parser/parser.y"
-{ yygotominor.yy20 = make_seq(make_detach(yymsp[-2].minor.yy20), yymsp[0].minor.yy20);   yy_destructor(yypParser,4,&yymsp[-1].minor);
+      case 8: /* seq1 ::= pipe SEMI pipe */
+#line 40 "parser/parser.y"
+{ yygotominor.yy4 = make_seq(yymsp[-2].minor.yy4, yymsp[0].minor.yy4);   yy_destructor(yypParser,1,&yymsp[-1].minor);
 }
-#line 821 "parser/parser.c"
+#line 838 "parser/parser.c"
         break;
-      case 9: /* pipe1 ::= redir PIPE redir */
-#line 38 "parser/parser.y"
-{ yygotominor.yy20 = make_pipe(yymsp[-2].minor.yy20, yymsp[0].minor.yy20);   yy_destructor(yypParser,2,&yymsp[-1].minor);
+      case 9: /* seq1 ::= pipe AMP pipe */
+#line 41 "parser/parser.y"
+{ yygotominor.yy4 = make_seq(make_detach(yymsp[-2].minor.yy4), yymsp[0].minor.yy4);   yy_destructor(yypParser,4,&yymsp[-1].minor);
 }
-#line 827 "parser/parser.c"
+#line 844 "parser/parser.c"
         break;
-      case 10: /* pipe1 ::= pipe1 PIPE redir */
-#line 39 "parser/parser.y"
-{ yygotominor.yy20 = extend_pipe(yymsp[-2].minor.yy20, yymsp[0].minor.yy20);   yy_destructor(yypParser,2,&yymsp[-1].minor);
+      case 10: /* seq1 ::= seq1 SEMI pipe */
+#line 42 "parser/parser.y"
+{ yygotominor.yy4 = extend_seq(yymsp[-2].minor.yy4, yymsp[0].minor.yy4);   yy_destructor(yypParser,1,&yymsp[-1].minor);
 }
-#line 833 "parser/parser.c"
+#line 850 "parser/parser.c"
         break;
-      case 12: /* redir ::= GT AMP NUMBER redir */
-#line 42 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, 1, 0, yymsp[-1].minor.yy0.number, 0); free(yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-3].minor);
+      case 11: /* seq1 ::= seq1 AMP pipe */
+#line 43 "parser/parser.y"
+{ yygotominor.yy4 = extend_seq(detach_last(yymsp[-2].minor.yy4), yymsp[0].minor.yy4);   yy_destructor(yypParser,4,&yymsp[-1].minor);
+}
+#line 856 "parser/parser.c"
+        break;
+      case 14: /* pipe1 ::= redir PIPE redir */
+#line 47 "parser/parser.y"
+{ yygotominor.yy4 = make_pipe(yymsp[-2].minor.yy4, yymsp[0].minor.yy4);   yy_destructor(yypParser,2,&yymsp[-1].minor);
+}
+#line 862 "parser/parser.c"
+        break;
+      case 15: /* pipe1 ::= pipe1 PIPE redir */
+#line 48 "parser/parser.y"
+{ yygotominor.yy4 = extend_pipe(yymsp[-2].minor.yy4, yymsp[0].minor.yy4);   yy_destructor(yypParser,2,&yymsp[-1].minor);
+}
+#line 868 "parser/parser.c"
+        break;
+      case 17: /* redir ::= GT AMP NUMBER redir */
+#line 51 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, 1, 0, yymsp[-1].minor.yy0.number, 0);   yy_destructor(yypParser,5,&yymsp[-3].minor);
   yy_destructor(yypParser,4,&yymsp[-2].minor);
 }
-#line 840 "parser/parser.c"
+#line 875 "parser/parser.c"
         break;
-      case 13: /* redir ::= GT WORD redir */
-#line 43 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, 1, 2, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-2].minor);
+      case 18: /* redir ::= GT WORD redir */
+#line 52 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, 1, 2, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-2].minor);
 }
-#line 846 "parser/parser.c"
+#line 881 "parser/parser.c"
         break;
-      case 14: /* redir ::= GT GT WORD redir */
-#line 44 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, 1, 3, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-3].minor);
+      case 19: /* redir ::= GT GT WORD redir */
+#line 53 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, 1, 3, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-3].minor);
   yy_destructor(yypParser,5,&yymsp[-2].minor);
 }
-#line 853 "parser/parser.c"
+#line 888 "parser/parser.c"
         break;
-      case 15: /* redir ::= LT WORD redir */
-#line 45 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, 0, 1, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,8,&yymsp[-2].minor);
+      case 20: /* redir ::= LT WORD redir */
+#line 54 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, 0, 1, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,8,&yymsp[-2].minor);
 }
-#line 859 "parser/parser.c"
+#line 894 "parser/parser.c"
         break;
-      case 16: /* redir ::= AMP GT AMP NUMBER redir */
-#line 46 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, -1, 0, yymsp[-1].minor.yy0.number, 0); free(yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,4,&yymsp[-4].minor);
+      case 21: /* redir ::= AMP GT AMP NUMBER redir */
+#line 55 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, -1, 0, yymsp[-1].minor.yy0.number, 0);   yy_destructor(yypParser,4,&yymsp[-4].minor);
   yy_destructor(yypParser,5,&yymsp[-3].minor);
   yy_destructor(yypParser,4,&yymsp[-2].minor);
 }
-#line 867 "parser/parser.c"
+#line 902 "parser/parser.c"
         break;
-      case 17: /* redir ::= AMP GT WORD redir */
-#line 47 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, -1, 2, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,4,&yymsp[-3].minor);
+      case 22: /* redir ::= AMP GT WORD redir */
+#line 56 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, -1, 2, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,4,&yymsp[-3].minor);
   yy_destructor(yypParser,5,&yymsp[-2].minor);
 }
-#line 874 "parser/parser.c"
+#line 909 "parser/parser.c"
         break;
-      case 18: /* redir ::= NUMBER GT AMP NUMBER redir */
-#line 48 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, yymsp[-4].minor.yy0.number, 0, yymsp[-1].minor.yy0.number, 0); free(yymsp[-1].minor.yy0.text); free(yymsp[-4].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-3].minor);
+      case 23: /* redir ::= NUMBER GT AMP NUMBER redir */
+#line 57 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, yymsp[-4].minor.yy0.number, 0, yymsp[-1].minor.yy0.number, 0);   yy_destructor(yypParser,5,&yymsp[-3].minor);
   yy_destructor(yypParser,4,&yymsp[-2].minor);
 }
-#line 881 "parser/parser.c"
+#line 916 "parser/parser.c"
         break;
-      case 19: /* redir ::= NUMBER GT WORD redir */
-#line 49 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, yymsp[-3].minor.yy0.number, 2, 0, yymsp[-1].minor.yy0.text); free(yymsp[-3].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-2].minor);
+      case 24: /* redir ::= NUMBER GT WORD redir */
+#line 58 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, yymsp[-3].minor.yy0.number, 2, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-2].minor);
 }
-#line 887 "parser/parser.c"
+#line 922 "parser/parser.c"
         break;
-      case 20: /* redir ::= NUMBER GT GT WORD redir */
-#line 50 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, yymsp[-4].minor.yy0.number, 3, 0, yymsp[-1].minor.yy0.text); free(yymsp[-4].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-3].minor);
+      case 25: /* redir ::= NUMBER GT GT WORD redir */
+#line 59 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, yymsp[-4].minor.yy0.number, 3, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,5,&yymsp[-3].minor);
   yy_destructor(yypParser,5,&yymsp[-2].minor);
 }
-#line 894 "parser/parser.c"
+#line 929 "parser/parser.c"
         break;
-      case 21: /* redir ::= NUMBER LT WORD redir */
-#line 51 "parser/parser.y"
-{ yygotominor.yy20 = make_redir(yymsp[0].minor.yy20, yymsp[-3].minor.yy0.number, 1, 0, yymsp[-1].minor.yy0.text); free(yymsp[-3].minor.yy0.text);   yy_destructor(yypParser,8,&yymsp[-2].minor);
+      case 26: /* redir ::= NUMBER LT WORD redir */
+#line 60 "parser/parser.y"
+{ yygotominor.yy4 = make_redir(yymsp[0].minor.yy4, yymsp[-3].minor.yy0.number, 1, 0, yymsp[-1].minor.yy0.text);   yy_destructor(yypParser,8,&yymsp[-2].minor);
 }
-#line 900 "parser/parser.c"
+#line 935 "parser/parser.c"
         break;
-      case 23: /* group ::= BRL seq BRR */
-#line 54 "parser/parser.y"
-{ yygotominor.yy20 = yymsp[-1].minor.yy20;   yy_destructor(yypParser,9,&yymsp[-2].minor);
+      case 27: /* group ::= simple */
+#line 62 "parser/parser.y"
+{ yygotominor.yy4 = freeze_simple(yymsp[0].minor.yy4); }
+#line 940 "parser/parser.c"
+        break;
+      case 28: /* group ::= BRL seq BRR */
+#line 63 "parser/parser.y"
+{ yygotominor.yy4 = yymsp[-1].minor.yy4;   yy_destructor(yypParser,9,&yymsp[-2].minor);
   yy_destructor(yypParser,10,&yymsp[0].minor);
 }
-#line 907 "parser/parser.c"
+#line 947 "parser/parser.c"
         break;
-      case 24: /* group ::= PL seq PR */
-#line 55 "parser/parser.y"
-{ yygotominor.yy20 = make_subshell(yymsp[-1].minor.yy20);   yy_destructor(yypParser,11,&yymsp[-2].minor);
+      case 29: /* group ::= PL seq PR */
+#line 64 "parser/parser.y"
+{ yygotominor.yy4 = make_subshell(yymsp[-1].minor.yy4);   yy_destructor(yypParser,11,&yymsp[-2].minor);
   yy_destructor(yypParser,12,&yymsp[0].minor);
 }
-#line 914 "parser/parser.c"
+#line 954 "parser/parser.c"
         break;
-      case 25: /* simple ::= WORD */
-      case 26: /* simple ::= NUMBER */ yytestcase(yyruleno==26);
-#line 57 "parser/parser.y"
-{ yygotominor.yy20 = make_simple(yymsp[0].minor.yy0.text); }
-#line 920 "parser/parser.c"
+      case 30: /* simple ::= WORD */
+#line 67 "parser/parser.y"
+{ yygotominor.yy4 = make_simple(yymsp[0].minor.yy0.text, yymsp[0].minor.yy0.quoted); }
+#line 959 "parser/parser.c"
         break;
-      case 27: /* simple ::= simple WORD */
-      case 28: /* simple ::= simple NUMBER */ yytestcase(yyruleno==28);
-#line 59 "parser/parser.y"
-{ yygotominor.yy20 = extend_simple(yymsp[-1].minor.yy20, yymsp[0].minor.yy0.text); }
-#line 926 "parser/parser.c"
+      case 31: /* simple ::= NUMBER */
+#line 68 "parser/parser.y"
+{ yygotominor.yy4 = make_simple(yymsp[0].minor.yy0.text, 1); }
+#line 964 "parser/parser.c"
+        break;
+      case 32: /* simple ::= simple WORD */
+#line 69 "parser/parser.y"
+{ yygotominor.yy4 = extend_simple(yymsp[-1].minor.yy4, yymsp[0].minor.yy0.text, yymsp[0].minor.yy0.quoted); }
+#line 969 "parser/parser.c"
+        break;
+      case 33: /* simple ::= simple NUMBER */
+#line 70 "parser/parser.y"
+{ yygotominor.yy4 = extend_simple(yymsp[-1].minor.yy4, yymsp[0].minor.yy0.text, 1); }
+#line 974 "parser/parser.c"
         break;
       default:
         break;
@@ -986,7 +1034,7 @@ static void yy_syntax_error(
 #define TOKEN (yyminor.yy0)
 #line 7 "parser/parser.y"
  fprintf(stderr, "mysh: syntax error\n"); parse_error = 1; 
-#line 990 "parser/parser.c"
+#line 1038 "parser/parser.c"
   ParseARG_STORE; /* Suppress warning about unused %extra_argument variable */
 }
 
@@ -1,5 +1,5 @@
 %token_type { struct lex_token }
-%token_destructor { if ($$.text) free($$.text); }
+%token_destructor { (void)$$; /* token text is owned by command_arena */ }
 %default_type { node_t * }
 %default_destructor { free_tree($$); }
 %type commands { int }
@@ -17,21 +17,30 @@
 #include <stdlib.h>
 int echo = 0;
 int parse_error = 0;
+node_t *parsed_tree = NULL; /* root of the last accepted parse */
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 }
 
 top ::= END. { }
 top ::= seq(A) END. { if (parse_error) free_tree(A);
-                      else { if (echo) print_tree_flat(A, 1);
+                      else { parsed_tree = A; /* retained for the parse cache */
+                             if (echo) print_tree_flat(A, 1);
                              run_command(A);
-                             free_tree(A);
                            } }
 
-seq(C) ::= pipe(A).             { C = A; }
-seq(C) ::= pipe(A) SEMI.        { C = A; }
-seq(C) ::= pipe(A) AMP.         { C = make_detach(A); }
-seq(C) ::= pipe(A) SEMI seq(B). { C = make_seq(A, B); }
-seq(C) ::= pipe(A) AMP seq(B).  { C = make_seq(make_detach(A), B); }
+// seq1 is left-recursive so a long chain grows one flat parts array
+// instead of nesting one node per separator.
+seq(C) ::= pipe(A).              { C = A; }
+seq(C) ::= pipe(A) SEMI.         { C = A; }
+seq(C) ::= pipe(A) AMP.          { C = make_detach(A); }
+seq(C) ::= seq1(A).              { C = A; }
+seq(C) ::= seq1(A) SEMI.         { C = A; }
+seq(C) ::= seq1(A) AMP.          { C = detach_last(A); }
+
+seq1(C) ::= pipe(A) SEMI pipe(B). { C = make_seq(A, B); }
+seq1(C) ::= pipe(A) AMP pipe(B).  { C = make_seq(make_detach(A), B); }
+seq1(C) ::= seq1(A) SEMI pipe(B). { C = extend_seq(A, B); }
+seq1(C) ::= seq1(A) AMP pipe(B).  { C = extend_seq(detach_last(A), B); }
 
 pipe(B) ::= redir(A).                { B = A; }
 pipe(B) ::= pipe1(A).                { B = A; }
@@ -39,22 +48,23 @@ pipe1(C) ::= redir(A) PIPE redir(B). { C = make_pipe(A, B); }
 pipe1(C) ::= pipe1(A) PIPE redir(B). { C = extend_pipe(A, B); }
 
 redir(C) ::= group(A).                               { C = A; }
-redir(C) ::=           GT    AMP NUMBER(B) redir(A). { C = make_redir(A, 1, 0, B.number, 0); free(B.text); }
+redir(C) ::=           GT    AMP NUMBER(B) redir(A). { C = make_redir(A, 1, 0, B.number, 0); }
 redir(C) ::=           GT    WORD(B) redir(A).       { C = make_redir(A, 1, 2, 0, B.text); }
 redir(C) ::=           GT GT WORD(B) redir(A).       { C = make_redir(A, 1, 3, 0, B.text); }
 redir(C) ::=           LT    WORD(B) redir(A).       { C = make_redir(A, 0, 1, 0, B.text); }
-redir(C) ::= AMP       GT    AMP NUMBER(B) redir(A). { C = make_redir(A, -1, 0, B.number, 0); free(B.text); }
+redir(C) ::= AMP       GT    AMP NUMBER(B) redir(A). { C = make_redir(A, -1, 0, B.number, 0); }
 redir(C) ::= AMP       GT    WORD(B) redir(A).       { C = make_redir(A, -1, 2, 0, B.text); }
-redir(C) ::= NUMBER(D) GT    AMP NUMBER(B) redir(A). { C = make_redir(A, D.number, 0, B.number, 0); free(B.text); free(D.text); }
-redir(C) ::= NUMBER(D) GT    WORD(B) redir(A).       { C = make_redir(A, D.number, 2, 0, B.text); free(D.text); }
-redir(C) ::= NUMBER(D) GT GT WORD(B) redir(A).       { C = make_redir(A, D.number, 3, 0, B.text); free(D.text); }
-redir(C) ::= NUMBER(D) LT    WORD(B) redir(A).       { C = make_redir(A, D.number, 1, 0, B.text); free(D.text); }
+redir(C) ::= NUMBER(D) GT    AMP NUMBER(B) redir(A). { C = make_redir(A, D.number, 0, B.number, 0); }
+redir(C) ::= NUMBER(D) GT    WORD(B) redir(A).       { C = make_redir(A, D.number, 2, 0, B.text); }
+redir(C) ::= NUMBER(D) GT GT WORD(B) redir(A).       { C = make_redir(A, D.number, 3, 0, B.text); }
+redir(C) ::= NUMBER(D) LT    WORD(B) redir(A).       { C = make_redir(A, D.number, 1, 0, B.text); }
 
-group(B) ::= simple(A).         { B = A; }
+group(B) ::= simple(A).         { B = freeze_simple(A); }
 group(B) ::= BRL seq(A) BRR. { B = A; }
 group(B) ::= PL seq(A) PR.   { B = make_subshell(A); }
 
-simple(B) ::= WORD(A).             { B = make_simple(A.text); }
-simple(B) ::= NUMBER(A).           { B = make_simple(A.text); }
-simple(C) ::= simple(A) WORD(B).   { C = extend_simple(A, B.text); }
-simple(C) ::= simple(A) NUMBER(B). { C = extend_simple(A, B.text); }
+// NUMBER words cannot carry a wildcard, so they pass quoted=1.
+simple(B) ::= WORD(A).             { B = make_simple(A.text, A.quoted); }
+simple(B) ::= NUMBER(A).           { B = make_simple(A.text, 1); }
+simple(C) ::= simple(A) WORD(B).   { C = extend_simple(A, B.text, B.quoted); }
+simple(C) ::= simple(A) NUMBER(B). { C = extend_simple(A, B.text, 1); }
@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "pathcache.h"
+
+#define PATH_BUCKETS 128 /* power of two */
+
+struct path_entry {
+    char *name;
+    char *path;
+    struct path_entry *next;
+};
+
+static struct path_entry *buckets[PATH_BUCKETS];
+
+/* The $PATH value the cache was built against. */
+static char *cached_path_var = NULL;
+
+static unsigned long hash_name(const char *s)
+{
+    unsigned long h = 2166136261ul;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619ul;
+    }
+    return h;
+}
+
+static void flush_cache(void)
+{
+    for (int i = 0; i < PATH_BUCKETS; i++) {
+        struct path_entry *e = buckets[i];
+        while (e) {
+            struct path_entry *next = e->next;
+            free(e->name);
+            free(e->path);
+            free(e);
+            e = next;
+        }
+        buckets[i] = NULL;
+    }
+}
+
+/* Walk $PATH looking for program; returns a malloc'd path or NULL. */
+static char *search_path(const char *program, const char *path_var)
+{
+    size_t prog_len = strlen(program);
+    const char *p = path_var;
+
+    while (1) {
+        const char *end = strchr(p, ':');
+        size_t dir_len = end ? (size_t)(end - p) : strlen(p);
+
+        /* An empty component means the current directory. */
+        const char *dir = dir_len ? p : ".";
+        if (!dir_len)
+            dir_len = 1;
+
+        char *full = malloc(dir_len + 1 + prog_len + 1);
+        memcpy(full, dir, dir_len);
+        full[dir_len] = '/';
+        memcpy(full + dir_len + 1, program, prog_len + 1);
+
+        if (access(full, X_OK) == 0)
+            return full;
+        free(full);
+
+        if (!end)
+            return NULL;
+        p = end + 1;
+    }
+}
+
+const char *path_resolve(const char *program)
+{
+    /* Paths with a slash are used as-is, like execvp does. */
+    if (strchr(program, '/'))
+        return program;
+
+    const char *path_var = getenv("PATH");
+    if (!path_var)
+        return NULL;
+
+    /* Rebuild from scratch if $PATH changed since the cache was filled. */
+    if (!cached_path_var || strcmp(cached_path_var, path_var) != 0) {
+        flush_cache();
+        free(cached_path_var);
+        cached_path_var = strdup(path_var);
+    }
+
+    struct path_entry **head = &buckets[hash_name(program) % PATH_BUCKETS];
+    for (struct path_entry *e = *head; e; e = e->next) {
+        if (strcmp(e->name, program) == 0) {
+            /* One access check instead of a full walk; re-resolve if the
+             * binary disappeared from under the cache. */
+            if (access(e->path, X_OK) == 0)
+                return e->path;
+            free(e->path);
+            e->path = search_path(program, path_var);
+            if (e->path)
+                return e->path;
+            /* Gone entirely; leave a negative entry out of the cache. */
+            struct path_entry **pp = head;
+            while (*pp != e)
+                pp = &(*pp)->next;
+            *pp = e->next;
+            free(e->name);
+            free(e);
+            return NULL;
+        }
+    }
+
+    char *path = search_path(program, path_var);
+    if (!path)
+        return NULL;
+
+    struct path_entry *e = malloc(sizeof(*e));
+    e->name = strdup(program);
+    e->path = path;
+    e->next = *head;
+    *head = e;
+    return path;
+}
+
+/*
+ * Executable-name index for completion: one sorted array of every
+ * executable name across $PATH, plus the mtime of each PATH directory so
+ * the index can be rebuilt when a directory's contents change.
+ */
+static char **index_names = NULL;
+static size_t index_count = 0, index_cap = 0;
+
+static struct dir_stamp {
+    char *dir;
+    time_t mtime; /* 0 when the directory could not be statted */
+} *index_dirs = NULL;
+static size_t index_n_dirs = 0;
+
+/* The $PATH value the index was built against. */
+static char *index_path_var = NULL;
+
+static void index_add_name(const char *name)
+{
+    if (index_count == index_cap) {
+        index_cap = index_cap ? index_cap * 2 : 256;
+        index_names = realloc(index_names, index_cap * sizeof(char *));
+    }
+    index_names[index_count++] = strdup(name);
+}
+
+static void index_add_dir(const char *dir, size_t dir_len)
+{
+    index_dirs = realloc(index_dirs,
+                         (index_n_dirs + 1) * sizeof(struct dir_stamp));
+
+    char *copy = malloc(dir_len + 1);
+    memcpy(copy, dir, dir_len);
+    copy[dir_len] = '\0';
+
+    struct dir_stamp *s = &index_dirs[index_n_dirs++];
+    s->dir = copy;
+    s->mtime = 0;
+
+    struct stat st;
+    if (stat(copy, &st) == 0)
+        s->mtime = st.st_mtime;
+
+    DIR *d = opendir(copy);
+    if (!d)
+        return;
+
+    int dfd = dirfd(d);
+    struct dirent *ent;
+    while ((ent = readdir(d))) {
+        if (ent->d_name[0] == '.')
+            continue;
+        if (faccessat(dfd, ent->d_name, X_OK, 0) == 0)
+            index_add_name(ent->d_name);
+    }
+    closedir(d);
+}
+
+static int name_cmp(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void index_build(const char *path_var)
+{
+    for (size_t i = 0; i < index_count; i++)
+        free(index_names[i]);
+    index_count = 0;
+    for (size_t i = 0; i < index_n_dirs; i++)
+        free(index_dirs[i].dir);
+    index_n_dirs = 0;
+
+    free(index_path_var);
+    index_path_var = strdup(path_var);
+
+    const char *p = path_var;
+    while (1) {
+        const char *end = strchr(p, ':');
+        size_t dir_len = end ? (size_t)(end - p) : strlen(p);
+
+        if (dir_len)
+            index_add_dir(p, dir_len);
+        else
+            index_add_dir(".", 1);
+
+        if (!end)
+            break;
+        p = end + 1;
+    }
+
+    qsort(index_names, index_count, sizeof(char *), name_cmp);
+
+    /* Drop duplicates (the same name earlier and later in $PATH). */
+    size_t out = 0;
+    for (size_t i = 0; i < index_count; i++) {
+        if (out && strcmp(index_names[i], index_names[out - 1]) == 0)
+            free(index_names[i]);
+        else
+            index_names[out++] = index_names[i];
+    }
+    index_count = out;
+}
+
+/* Rebuild only when $PATH itself or a directory's mtime changed. */
+static void index_refresh(void)
+{
+    const char *path_var = getenv("PATH");
+    if (!path_var)
+        path_var = "";
+
+    if (index_path_var && strcmp(index_path_var, path_var) == 0) {
+        int stale = 0;
+        for (size_t i = 0; i < index_n_dirs && !stale; i++) {
+            struct stat st;
+            time_t mtime = stat(index_dirs[i].dir, &st) == 0 ? st.st_mtime : 0;
+            if (mtime != index_dirs[i].mtime)
+                stale = 1;
+        }
+        if (!stale)
+            return;
+    }
+
+    index_build(path_var);
+}
+
+const char *path_index_match(const char *prefix, size_t idx)
+{
+    index_refresh();
+
+    /* Binary search for the first name >= prefix; matches follow it. */
+    size_t len = strlen(prefix);
+    size_t lo = 0, hi = index_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strcmp(index_names[mid], prefix) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo + idx >= index_count)
+        return NULL;
+    const char *name = index_names[lo + idx];
+    return strncmp(name, prefix, len) == 0 ? name : NULL;
+}
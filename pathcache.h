@@ -0,0 +1,26 @@
+#ifndef SHELL_PATHCACHE_H
+#define SHELL_PATHCACHE_H
+
+/*
+ * Cache of $PATH lookups, so a program that is executed over and over does
+ * not re-walk every PATH directory each time.
+ *
+ * Returns the path to exec directly (with execv), or NULL if the program
+ * could not be found; callers should fall back to execvp in that case.
+ * The cache is flushed when $PATH changes, and a cached entry that no
+ * longer passes an access check is re-resolved, so deleted or replaced
+ * binaries are picked up again.
+ */
+const char *path_resolve(const char *program);
+
+/*
+ * Prebuilt index of every executable name across $PATH, for command-name
+ * completion: return the idx'th name starting with prefix (in sorted
+ * order), or NULL when there are no more matches. The index is built on
+ * first use and rebuilt when $PATH or any PATH directory's mtime changes,
+ * so a completion request is an in-memory prefix lookup, not a directory
+ * scan.
+ */
+const char *path_index_match(const char *prefix, size_t idx);
+
+#endif
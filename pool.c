@@ -0,0 +1,241 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "pool.h"
+
+#define POOL_MAX 64
+#define POOL_MSG_MAX (64 * 1024)
+
+/*
+ * One request message (SOCK_SEQPACKET keeps the boundaries):
+ *   struct req_header, then cwd\0 path\0 argv[0]\0 ... argv[argc-1]\0
+ * with the client's stdio attached as SCM_RIGHTS. path is empty when
+ * $PATH resolution failed and the worker should go straight to execvp.
+ */
+struct req_header {
+    unsigned int argc;
+};
+
+static struct worker {
+    pid_t pid;
+    int sock;
+} workers[POOL_MAX];
+
+static int n_workers; /* idle workers currently in the array */
+static int pool_size; /* configured target */
+
+int pool_active(void)
+{
+    return n_workers > 0;
+}
+
+static void worker_main(int sock)
+{
+    char buf[POOL_MSG_MAX];
+    struct iovec iov = { buf, sizeof(buf) - 1 };
+    union {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(3 * sizeof(int))];
+    } cbuf;
+    struct msghdr msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf.data;
+    msg.msg_controllen = sizeof(cbuf.data);
+
+    ssize_t n;
+    while ((n = recvmsg(sock, &msg, 0)) < 0 && errno == EINTR)
+        ;
+    if (n <= (ssize_t)sizeof(struct req_header))
+        _exit(0); /* shell went away, or garbage */
+    buf[n] = '\0';
+
+    /* Install the dispatch-time stdio. */
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    if (!c || c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS ||
+        c->cmsg_len != CMSG_LEN(3 * sizeof(int)))
+        _exit(1);
+    int fds[3];
+    memcpy(fds, CMSG_DATA(c), sizeof(fds));
+    for (int i = 0; i < 3; i++) {
+        dup2(fds[i], i);
+        close(fds[i]);
+    }
+
+    struct req_header hdr;
+    memcpy(&hdr, buf, sizeof(hdr));
+
+    char *p = buf + sizeof(hdr);
+    char *end = buf + n;
+
+    /* The worker was forked earlier; catch up with the shell's cwd. */
+    char *cwd = p;
+    p += strlen(p) + 1;
+    if (chdir(cwd) == 0)
+        setenv("PWD", cwd, 1);
+
+    char *path = p;
+    p += strlen(p) + 1;
+
+    char **argv = malloc((hdr.argc + 1) * sizeof(char *));
+    for (unsigned int i = 0; i < hdr.argc; i++) {
+        if (p >= end)
+            _exit(1);
+        argv[i] = p;
+        p += strlen(p) + 1;
+    }
+    argv[hdr.argc] = NULL;
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGQUIT, SIG_DFL);
+    signal(SIGTSTP, SIG_DFL);
+
+    /* Same fallback chain as exec_program in shell.c. */
+    if (path[0])
+        execv(path, argv);
+    execvp(argv[0], argv);
+    perror(argv[0]);
+    _exit(1);
+}
+
+static int spawn_worker(void)
+{
+    int sp[2];
+
+    if (n_workers >= POOL_MAX)
+        return -1;
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sp) < 0)
+        return -1;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(sp[0]);
+        close(sp[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        /* Drop the parent ends of the other workers, so closing a
+         * worker's socket in the shell reliably reaches EOF. */
+        for (int i = 0; i < n_workers; i++)
+            close(workers[i].sock);
+        close(sp[0]);
+        worker_main(sp[1]);
+        _exit(1); /* not reached */
+    }
+
+    close(sp[1]);
+    workers[n_workers].pid = pid;
+    workers[n_workers].sock = sp[0];
+    n_workers++;
+    return 0;
+}
+
+pid_t pool_dispatch(const char *path, const char *program, char **argv)
+{
+    (void)program;
+
+    char payload[POOL_MSG_MAX];
+    struct req_header hdr = { 0 };
+    size_t len = sizeof(hdr);
+
+    char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)) == NULL)
+        cwd[0] = '\0';
+
+    size_t need = strlen(cwd) + 1 + (path ? strlen(path) : 0) + 1;
+    if (len + need > sizeof(payload))
+        return -1;
+    strcpy(payload + len, cwd);
+    len += strlen(cwd) + 1;
+    strcpy(payload + len, path ? path : "");
+    len += (path ? strlen(path) : 0) + 1;
+
+    for (unsigned int i = 0; argv[i]; i++) {
+        size_t l = strlen(argv[i]) + 1;
+        if (len + l > sizeof(payload))
+            return -1; /* oversized argv falls back to fork/exec */
+        memcpy(payload + len, argv[i], l);
+        len += l;
+        hdr.argc++;
+    }
+    memcpy(payload, &hdr, sizeof(hdr));
+
+    while (n_workers > 0) {
+        struct worker w = workers[--n_workers];
+
+        struct iovec iov = { payload, len };
+        union {
+            struct cmsghdr align;
+            char data[CMSG_SPACE(3 * sizeof(int))];
+        } cbuf;
+        struct msghdr msg;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = cbuf.data;
+        msg.msg_controllen = sizeof(cbuf.data);
+
+        struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(3 * sizeof(int));
+        int stdio_fds[3] = { 0, 1, 2 };
+        memcpy(CMSG_DATA(c), stdio_fds, sizeof(stdio_fds));
+
+        ssize_t sent = sendmsg(w.sock, &msg, 0);
+        close(w.sock);
+
+        if (sent < 0) {
+            /* Worker died; reap it and try the next one. */
+            waitpid(w.pid, NULL, 0);
+            continue;
+        }
+
+        /* Replenish while the command runs: the replacement fork happens
+         * off the next command's critical path. */
+        while (n_workers < pool_size && spawn_worker() == 0)
+            ;
+
+        return w.pid;
+    }
+
+    return -1;
+}
+
+static void pool_shutdown(void)
+{
+    /* EOF on the socket tells each idle worker to exit. */
+    for (int i = 0; i < n_workers; i++) {
+        close(workers[i].sock);
+        waitpid(workers[i].pid, NULL, 0);
+    }
+    n_workers = 0;
+}
+
+void pool_init(void)
+{
+    const char *env = getenv("MYSH_WORKERS");
+    if (!env)
+        return;
+
+    pool_size = atoi(env);
+    if (pool_size < 0)
+        pool_size = 0;
+    if (pool_size > POOL_MAX)
+        pool_size = POOL_MAX;
+
+    while (n_workers < pool_size && spawn_worker() == 0)
+        ;
+    if (pool_size)
+        atexit(pool_shutdown);
+}
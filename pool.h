@@ -0,0 +1,30 @@
+#ifndef SHELL_POOL_H
+#define SHELL_POOL_H
+
+#include <sys/types.h>
+
+/*
+ * Preforked worker pool: MYSH_WORKERS=N keeps N idle, already-forked
+ * processes waiting on socketpairs. execute_command hands one a resolved
+ * path, argv and the current stdio descriptors (SCM_RIGHTS); the worker
+ * execs the command and so becomes it, and the pool forks a replacement
+ * while the command runs. That moves fork latency off the per-command
+ * critical path, which matters most under the ASan build and in daemon
+ * mode where commands arrive back to back.
+ */
+
+/* Read MYSH_WORKERS and prefork the pool. Called once at startup. */
+void pool_init(void);
+
+/* Cheap check for the dispatch fast path. */
+int pool_active(void);
+
+/*
+ * Hand a command to an idle worker; returns the pid now running it (wait
+ * for it like a forked child), or -1 when the pool is empty or the request
+ * does not fit, in which case the caller falls back to fork/exec. path may
+ * be NULL when $PATH resolution failed; the worker then relies on execvp.
+ */
+pid_t pool_dispatch(const char *path, const char *program, char **argv);
+
+#endif
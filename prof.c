@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "prof.h"
+
+int prof_enabled = 0;
+
+/* Forked children inherit the atexit hook; only the shell itself reports. */
+static pid_t prof_pid;
+
+/* Buckets are powers of two of microseconds: <1us, 1-2us, 2-4us, ... */
+#define PROF_NBUCKETS 24
+
+static struct counter {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t buckets[PROF_NBUCKETS];
+} counters[PROF_NCOUNTERS];
+
+static const char *counter_names[PROF_NCOUNTERS] = {
+    [PROF_LEX]            = "lex",
+    [PROF_PARSE]          = "parse",
+    [PROF_COMMAND_SPAWN]  = "command spawn",
+    [PROF_COMMAND_WAIT]   = "command wait",
+    [PROF_PIPE_SETUP]     = "pipe setup",
+    [PROF_PIPE_WAIT]      = "pipe wait",
+    [PROF_REDIRECT_SPAWN] = "redirect spawn",
+    [PROF_REDIRECT_WAIT]  = "redirect wait",
+};
+
+void prof_account(enum prof_counter c, uint64_t ns)
+{
+    struct counter *ctr = &counters[c];
+
+    ctr->count++;
+    ctr->total_ns += ns;
+
+    int b = 0;
+    for (uint64_t us = ns / 1000; us; us >>= 1)
+        b++;
+    if (b >= PROF_NBUCKETS)
+        b = PROF_NBUCKETS - 1;
+    ctr->buckets[b]++;
+}
+
+static void print_bucket_label(int b)
+{
+    /* Bucket b covers [2^(b-1), 2^b) microseconds; bucket 0 is <1us. */
+    uint64_t hi = 1ull << b;
+    if (b == 0)
+        fprintf(stderr, "<1us");
+    else if (hi <= 1024)
+        fprintf(stderr, "%llu-%lluus",
+                (unsigned long long)(hi / 2), (unsigned long long)hi);
+    else
+        fprintf(stderr, "%llu-%llums",
+                (unsigned long long)(hi / 2048), (unsigned long long)(hi / 1024));
+}
+
+static void prof_dump(void)
+{
+    if (getpid() != prof_pid)
+        return;
+
+    fprintf(stderr, "mysh profile (MYSH_PROF):\n");
+
+    for (int c = 0; c < PROF_NCOUNTERS; c++) {
+        struct counter *ctr = &counters[c];
+        if (!ctr->count)
+            continue;
+
+        fprintf(stderr, "  %-14s calls %8llu  total %8.3fms  avg %7.1fus\n",
+                counter_names[c],
+                (unsigned long long)ctr->count,
+                ctr->total_ns / 1e6,
+                ctr->total_ns / 1e3 / ctr->count);
+
+        fprintf(stderr, "    ");
+        for (int b = 0; b < PROF_NBUCKETS; b++) {
+            if (!ctr->buckets[b])
+                continue;
+            print_bucket_label(b);
+            fprintf(stderr, ":%llu ", (unsigned long long)ctr->buckets[b]);
+        }
+        fprintf(stderr, "\n");
+    }
+}
+
+void prof_init(void)
+{
+    if (getenv("MYSH_PROF")) {
+        prof_enabled = 1;
+        prof_pid = getpid();
+        atexit(prof_dump);
+    }
+}
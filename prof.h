@@ -0,0 +1,52 @@
+#ifndef SHELL_PROF_H
+#define SHELL_PROF_H
+
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Lightweight hot-path instrumentation: monotonic-clock counters around
+ * lexing, parsing and the fork/exec/wait sections of the executors,
+ * accumulated per section and dumped as a histogram summary at exit.
+ * Enabled by setting MYSH_PROF in the environment; when disabled every
+ * probe costs one predictable branch, so the probes stay compiled in.
+ */
+
+enum prof_counter {
+    PROF_LEX,            /* yylex calls */
+    PROF_PARSE,          /* Parse calls */
+    PROF_COMMAND_SPAWN,  /* execute_command: fork/posix_spawn until running */
+    PROF_COMMAND_WAIT,   /* execute_command: waitpid */
+    PROF_PIPE_SETUP,     /* execute_pipe: pipes created, stages forked */
+    PROF_PIPE_WAIT,      /* execute_pipe: waiting for all stages */
+    PROF_REDIRECT_SPAWN, /* execute_redirect: spawn fast path */
+    PROF_REDIRECT_WAIT,  /* execute_redirect: waitpid on spawned child */
+    PROF_NCOUNTERS
+};
+
+extern int prof_enabled;
+
+/* Read MYSH_PROF and register the at-exit report. Called once at startup. */
+void prof_init(void);
+
+void prof_account(enum prof_counter c, uint64_t ns);
+
+static inline uint64_t prof_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static inline uint64_t prof_begin(void)
+{
+    return prof_enabled ? prof_now() : 0;
+}
+
+static inline void prof_end(enum prof_counter c, uint64_t t0)
+{
+    if (prof_enabled)
+        prof_account(c, prof_now() - t0);
+}
+
+#endif
@@ -0,0 +1,118 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include "reap.h"
+
+/* -1 until probed; pidfd_open returning ENOSYS pins it to 0. */
+static int reap_supported = -1;
+
+/* Stragglers left behind by an early return, reaped by reap_poll. */
+static pid_t *orphans = NULL;
+static size_t n_orphans, orphans_cap;
+
+static int pidfd_open_(pid_t pid)
+{
+    /* Raw syscall: the glibc wrapper is newer than the kernel feature. */
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+}
+
+static void orphan_add(pid_t pid)
+{
+    if (n_orphans == orphans_cap) {
+        orphans_cap = orphans_cap ? orphans_cap * 2 : 8;
+        orphans = realloc(orphans, orphans_cap * sizeof(pid_t));
+    }
+    orphans[n_orphans++] = pid;
+}
+
+void reap_poll(void)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < n_orphans; i++)
+        if (waitpid(orphans[i], NULL, WNOHANG) <= 0)
+            orphans[out++] = orphans[i];
+    n_orphans = out;
+}
+
+void reap_pids(pid_t *pids, int n, int early_return)
+{
+    if (n <= 0)
+        return;
+
+    int ep = -1;
+    int *pfds = NULL;
+
+    if (reap_supported == 0 || (ep = epoll_create1(EPOLL_CLOEXEC)) < 0)
+        goto fallback;
+
+    pfds = malloc(n * sizeof(int));
+    int live = 0;
+    int last_done = 0;
+
+    for (int i = 0; i < n; i++) {
+        pfds[i] = pidfd_open_(pids[i]);
+        if (pfds[i] < 0) {
+            if (errno == ENOSYS) {
+                reap_supported = 0;
+                for (int j = 0; j < i; j++)
+                    close(pfds[j]);
+                close(ep);
+                goto fallback;
+            }
+            /* Can't watch this one; collect it the old way. */
+            waitpid(pids[i], NULL, 0);
+            if (i == n - 1)
+                last_done = 1;
+            continue;
+        }
+
+        /* A pidfd polls readable once the process exits. */
+        struct epoll_event ev = { .events = EPOLLIN, .data = { .u32 = i } };
+        epoll_ctl(ep, EPOLL_CTL_ADD, pfds[i], &ev);
+        live++;
+    }
+    reap_supported = 1;
+
+    while (live > 0 && !(early_return && last_done)) {
+        struct epoll_event evs[16];
+        int k = epoll_wait(ep, evs, 16, -1);
+        if (k < 0) {
+            if (errno == EINTR)
+                continue;
+            break; /* should not happen; the loop below cleans up */
+        }
+
+        for (int e = 0; e < k; e++) {
+            int i = (int)evs[e].data.u32;
+            waitpid(pids[i], NULL, 0);
+            close(pfds[i]);
+            pfds[i] = -1;
+            live--;
+            if (i == n - 1)
+                last_done = 1;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (pfds[i] < 0)
+            continue;
+        close(pfds[i]);
+        if (early_return && last_done)
+            orphan_add(pids[i]); /* still running; collect later */
+        else
+            waitpid(pids[i], NULL, 0); /* epoll failed mid-way */
+    }
+
+    close(ep);
+    free(pfds);
+    return;
+
+fallback:
+    free(pfds);
+    for (int i = 0; i < n; i++)
+        waitpid(pids[i], NULL, 0);
+}
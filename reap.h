@@ -0,0 +1,26 @@
+#ifndef SHELL_REAP_H
+#define SHELL_REAP_H
+
+#include <sys/types.h>
+
+/*
+ * Event-driven child collection: every pid gets a pidfd and completion is
+ * handled through one epoll instance as the exits arrive, in any order, so
+ * a slow pipeline stage never delays collecting the stages after it. On
+ * kernels without pidfd_open the whole module degrades to the plain
+ * waitpid loop it replaced.
+ */
+
+/*
+ * Wait for the n children in pids. With early_return set, hand control
+ * back as soon as the last pid (the pipeline's final stage, the one whose
+ * exit closes the output) has been collected; any stragglers are parked
+ * and reaped opportunistically by reap_poll.
+ */
+void reap_pids(pid_t *pids, int n, int early_return);
+
+/* Collect any parked stragglers that have since exited. Cheap when the
+ * list is empty; called from jobs_reap alongside the job poll. */
+void reap_poll(void);
+
+#endif
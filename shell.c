@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -5,16 +6,106 @@
 #include <sys/wait.h>
 #include <string.h>
 #include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <sys/resource.h>
 #include <errno.h>
 #include <fcntl.h>
 #include "parser/ast.h"
+#include "builtins.h"
+#include "jobs.h"
+#include "pathcache.h"
+#include "pool.h"
+#include "prof.h"
+#include "reap.h"
 #include "shell.h"
 
+/*
+ * Exec a program with a path resolved through the $PATH cache. Resolution
+ * happens in the parent (see path_resolve callers) so the cache warms up
+ * across invocations; the forked child just execs the result directly.
+ * Only returns if exec failed.
+ */
+static void exec_program(const char *path, char *program, char **argv)
+{
+    if (path)
+        execv(path, argv);
+
+    /* Either resolution failed, the cached path went stale, or the file is
+     * a script without a shebang; execvp handles all of those. */
+    execvp(program, argv);
+
+    perror(program);
+    exit(1);
+}
+
+extern char **environ;
+
+/*
+ * Spawn engine: when enabled (MYSH_SPAWN set to anything but "fork"), plain
+ * commands and simple redirected commands start via posix_spawn instead of
+ * fork+exec, so the common path never duplicates the shell's address space.
+ * Cases that need a child shell context still fork.
+ */
+static int use_spawn = 0;
+
+/*
+ * Pipe buffer size (bytes) to request with F_SETPIPE_SZ for every pipeline
+ * pipe; 0 leaves the kernel default. Set via MYSH_PIPE_SIZE for
+ * bulk-throughput pipelines, where a bigger buffer means fewer context
+ * switches between the stages.
+ */
+static long pipe_buf_size = 0;
+
+/*
+ * When MYSH_PIPE_RUSAGE is set, every pipeline stage is collected with
+ * wait4 and its real/user/sys cost reported on stderr, so the expensive
+ * stage of `extract | transform | load` shows up without external tooling.
+ */
+static int pipe_rusage = 0;
+
+/*
+ * When MYSH_PIPE_EARLY is set, execute_pipe returns as soon as the final
+ * stage has exited instead of waiting for every stage: once the stage
+ * producing the output is done there is rarely a reason to hold the
+ * prompt for upstream stragglers (e.g. a producer blocked on a full pipe
+ * whose consumer quit). Leftovers are reaped in the background.
+ */
+static int pipe_early = 0;
+
 void initialize(void)
 {
     /* This code will be called once at startup */
     if (prompt)
         prompt = "vush$ ";
+
+    const char *spawn_env = getenv("MYSH_SPAWN");
+    use_spawn = spawn_env != NULL && strcmp(spawn_env, "fork") != 0;
+
+    /* Hot-path timing counters, enabled by MYSH_PROF */
+    prof_init();
+
+    pipe_rusage = getenv("MYSH_PIPE_RUSAGE") != NULL;
+    pipe_early = getenv("MYSH_PIPE_EARLY") != NULL;
+
+    /* Preforked worker pool, enabled by MYSH_WORKERS */
+    pool_init();
+
+    const char *pipe_env = getenv("MYSH_PIPE_SIZE");
+    if (pipe_env) {
+        pipe_buf_size = atol(pipe_env);
+        if (pipe_buf_size < 0)
+            pipe_buf_size = 0;
+
+        // Clamp to the kernel limit so F_SETPIPE_SZ cannot fail with EPERM
+        FILE *f = fopen("/proc/sys/fs/pipe-max-size", "r");
+        if (f) {
+            long max;
+            if (fscanf(f, "%ld", &max) == 1 && pipe_buf_size > max)
+                pipe_buf_size = max;
+            fclose(f);
+        }
+    }
     
     // Ignore signals in the shell
     signal(SIGINT, SIG_IGN);
@@ -22,6 +113,79 @@ void initialize(void)
     signal(SIGQUIT, SIG_IGN);
     // Ignore stop signal
     signal(SIGTSTP, SIG_IGN);
+
+    builtins_init();
+    jobs_init();
+}
+
+/*
+ * Try to start a plain command (optionally wrapped in one redirection) with
+ * posix_spawn. Returns 0 and stores the child pid on success, -1 if the
+ * caller should use the fork path instead (builtins, unresolvable programs,
+ * spawn failure).
+ */
+static int spawn_command(node_t *cmd, node_t *redir, pid_t *pid_out)
+{
+    if (cmd->type != NODE_COMMAND || builtin_lookup(cmd->command.program))
+        return -1;
+
+    const char *path = path_resolve(cmd->command.program);
+    if (!path)
+        return -1;
+
+    posix_spawn_file_actions_t fa;
+    posix_spawnattr_t attr;
+    sigset_t defsigs;
+    int err;
+
+    posix_spawn_file_actions_init(&fa);
+    posix_spawnattr_init(&attr);
+
+    /* The shell ignores job-control signals; children get the defaults. */
+    sigemptyset(&defsigs);
+    sigaddset(&defsigs, SIGINT);
+    sigaddset(&defsigs, SIGQUIT);
+    sigaddset(&defsigs, SIGTSTP);
+    posix_spawnattr_setsigdefault(&attr, &defsigs);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+    if (redir) {
+        int fd = redir->redirect.fd;
+        int target_fd = (fd < 0) ? STDOUT_FILENO : fd;
+
+        switch (redir->redirect.mode) {
+        case REDIRECT_INPUT:
+            posix_spawn_file_actions_addopen(&fa, STDIN_FILENO,
+                                             redir->redirect.target,
+                                             O_RDONLY, 0);
+            break;
+
+        case REDIRECT_OUTPUT:
+        case REDIRECT_APPEND:
+            posix_spawn_file_actions_addopen(&fa, target_fd,
+                redir->redirect.target,
+                O_WRONLY | O_CREAT |
+                    (redir->redirect.mode == REDIRECT_APPEND ? O_APPEND
+                                                             : O_TRUNC),
+                0644);
+            // fd < 0 means stdout and stderr both go to the file
+            if (fd < 0)
+                posix_spawn_file_actions_adddup2(&fa, STDOUT_FILENO,
+                                                 STDERR_FILENO);
+            break;
+
+        case REDIRECT_DUP:
+            posix_spawn_file_actions_adddup2(&fa, redir->redirect.fd2, fd);
+            break;
+        }
+    }
+
+    err = posix_spawn(pid_out, path, &fa, &attr, cmd->command.argv, environ);
+
+    posix_spawn_file_actions_destroy(&fa);
+    posix_spawnattr_destroy(&attr);
+
+    return err ? -1 : 0;
 }
 
 void execute_command(node_t *node) {
@@ -29,43 +193,48 @@ void execute_command(node_t *node) {
     char **argv = node->command.argv;
     int argc = node->command.argc;
     
-    // Special case, built-in commands
-    if (strcmp(program, "exit") == 0) {
-        int exit_code = 0;
-        
-        // Check for an exit code argument
-        if (argc > 1) {
-            exit_code = atoi(argv[1]);
-        }
-        
-        exit(exit_code);
+    // Special case, built-in commands: run in-process, no fork
+    const struct builtin *b = builtin_lookup(program);
+    if (b) {
+        b->fn(argc, argv);
+        // Flush now so builtin output is ordered before any child's output
+        fflush(stdout);
+        return;
     }
-    
-    if (strcmp(program, "cd") == 0) {
-        char *path;
-        
-        // Get target directory
-        if (argc < 2) {
-            path = getenv("HOME");
-            if (path == NULL) {
-                fprintf(stderr, "cd: HOME not set\n");
-                return;
-            }
-        }
-        else {
-            path = argv[1];
+
+    uint64_t t0 = prof_begin();
+
+    // Fastest path: hand the command to a preforked worker, no fork at all
+    if (pool_active()) {
+        pid_t wpid = pool_dispatch(path_resolve(program), program, argv);
+        if (wpid > 0) {
+            prof_end(PROF_COMMAND_SPAWN, t0);
+            int status;
+            t0 = prof_begin();
+            waitpid(wpid, &status, 0);
+            prof_end(PROF_COMMAND_WAIT, t0);
+            return;
         }
-        
-        if (chdir(path) < 0) {
-            perror("cd");
+    }
+
+    // Fast path: no fork at all when the spawn engine is enabled
+    if (use_spawn) {
+        pid_t spid;
+        if (spawn_command(node, NULL, &spid) == 0) {
+            prof_end(PROF_COMMAND_SPAWN, t0);
+            int status;
+            t0 = prof_begin();
+            waitpid(spid, &status, 0);
+            prof_end(PROF_COMMAND_WAIT, t0);
+            return;
         }
-        
-        return;
     }
-    
-    // Base case
+
+    // Base case; resolve through the $PATH cache before forking
+    const char *path = path_resolve(program);
     pid_t pid = fork();
-    
+    prof_end(PROF_COMMAND_SPAWN, t0);
+
     if (pid < 0) {
         perror("fork");
         return;
@@ -75,86 +244,175 @@ void execute_command(node_t *node) {
         signal(SIGINT, SIG_DFL);
         signal(SIGQUIT, SIG_DFL);
         signal(SIGTSTP, SIG_DFL);
-        
-        // Child Process, execute
-        execvp(program, argv);
-        
-        // execvp failed
-        perror(program);
-        exit(1);
+
+        // Child Process, execute; does not return unless exec failed
+        exec_program(path, program, argv);
     }
     else {
         // Parent Process, waits for the child to finish
         int status;
+        t0 = prof_begin();
         waitpid(pid, &status, 0);
+        prof_end(PROF_COMMAND_WAIT, t0);
     }
 }
 
+int parallel_sequences = 0;
+
+static int tree_mutates_shell(node_t *node);
+
+/* Outstanding workers of a parallel sequence, oldest first. */
+struct seq_workers {
+    pid_t pids[256];
+    int head, count;
+};
+
+static void seq_wait_oldest(struct seq_workers *w)
+{
+    waitpid(w->pids[w->head % 256], NULL, 0);
+    w->head++;
+    w->count--;
+}
+
+static void seq_run_parallel(struct seq_workers *w, int limit, node_t *part)
+{
+    while (w->count >= limit || w->count >= 256)
+        seq_wait_oldest(w);
+
+    fflush(stdout); // children must not inherit buffered output
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        run_command(part); // degrade to serial rather than dropping it
+        return;
+    }
+    if (pid == 0) {
+        run_command(part);
+        exit(0);
+    }
+
+    w->pids[(w->head + w->count) % 256] = pid;
+    w->count++;
+}
+
 void execute_sequence(node_t *node) {
-    run_command(node->sequence.first);
-    run_command(node->sequence.second);
+    if (!parallel_sequences) {
+        // The parts are a flat array, so a 100k-command script costs
+        // one loop here, not 100k stack frames.
+        for (size_t i = 0; i < node->sequence.n_parts; i++)
+            run_command(node->sequence.parts[i]);
+        return;
+    }
+
+    /*
+     * Parallel mode: run independent parts concurrently up to the core
+     * count. A part that mutates shell state is a barrier: everything
+     * before it finishes first, then it runs in-process, in order.
+     */
+    long limit = sysconf(_SC_NPROCESSORS_ONLN);
+    if (limit < 1)
+        limit = 1;
+
+    struct seq_workers w = { .head = 0, .count = 0 };
+
+    for (size_t i = 0; i < node->sequence.n_parts; i++) {
+        node_t *part = node->sequence.parts[i];
+
+        if (tree_mutates_shell(part)) {
+            while (w.count > 0)
+                seq_wait_oldest(&w);
+            run_command(part);
+        } else {
+            seq_run_parallel(&w, (int)limit, part);
+        }
+    }
+
+    while (w.count > 0)
+        seq_wait_oldest(&w);
 }
 
 void execute_pipe(node_t *node) {
     int n = node->pipe.n_parts;
-    
+    int started = 0;
+
     // Array of PIDs of child processes
     pid_t *pids = malloc(n * sizeof(pid_t));
-    
-    // Array of pipes    
-    int (*pipes)[2] = malloc((n - 1) * sizeof(int[2]));
-    
-    // Creates the pipes   
-    for (int i = 0; i < n - 1; i++) {
-        if (pipe(pipes[i]) < 0) {
-            perror("pipe");
-            free(pids);
-            free(pipes);
-            return;
-        }
-    }
-    
+
+    /*
+     * Pipes are created one at a time as the children are forked: the
+     * parent only ever holds the read end of the previous pipe plus the
+     * pipe for the next stage, so setup stays O(n) syscalls and the open
+     * descriptor count is bounded no matter how long the pipeline is.
+     * O_CLOEXEC means exec'ing children inherit nothing they must close.
+     */
+    int prev_read = -1; // read end connecting to the previous stage
+    int p[2] = { -1, -1 };
+
+    struct timespec launch;
+    if (pipe_rusage)
+        clock_gettime(CLOCK_MONOTONIC, &launch);
+
+    uint64_t t0 = prof_begin();
+
+    // Stages running builtins or subtrees exit() and would flush any
+    // buffered output they inherit, duplicating it once per stage
+    fflush(stdout);
+
     // Creates a process for each command
     for (int i = 0; i < n; i++) {
+        if (i < n - 1 && pipe2(p, O_CLOEXEC) < 0) {
+            perror("pipe2");
+            break;
+        }
+
+        // Best effort: a refused size just leaves the kernel default
+        if (i < n - 1 && pipe_buf_size > 0)
+            (void)fcntl(p[1], F_SETPIPE_SZ, (int)pipe_buf_size);
+
+        // Builtin/path lookups happen pre-fork so the cache stays warm
+        node_t *cmd = node->pipe.parts[i];
+        const struct builtin *b = NULL;
+        const char *path = NULL;
+
+        if (cmd->type == NODE_COMMAND) {
+            b = builtin_lookup(cmd->command.program);
+            if (!b)
+                path = path_resolve(cmd->command.program);
+        }
+
         pids[i] = fork();
-        
+
         if (pids[i] < 0) {
             perror("fork");
-
-            // Cleanup
-            for (int j = 0; j < n - 1; j++) {
-                close(pipes[j][0]);
-                close(pipes[j][1]);
+            if (i < n - 1) {
+                close(p[0]);
+                close(p[1]);
             }
-            
-            free(pids);
-            free(pipes);
-            return;
+            break;
         }
-        
+
         if (pids[i] == 0) {
             // If not first command, read from previous pipe
-            if (i > 0) {
-                dup2(pipes[i - 1][0], STDIN_FILENO);
+            if (prev_read >= 0) {
+                dup2(prev_read, STDIN_FILENO);
+                close(prev_read);
             }
-            
+
             // If not last command, write to next pipe
             if (i < n - 1) {
-                dup2(pipes[i][1], STDOUT_FILENO);
+                dup2(p[1], STDOUT_FILENO);
+                close(p[0]);
+                close(p[1]);
             }
-            
-            for (int j = 0; j < n - 1; j++) {
-                close(pipes[j][0]);
-                close(pipes[j][1]);
-            }
-            
+
             // Execute the command
-            node_t *cmd = node->pipe.parts[i];
-            
             if (cmd->type == NODE_COMMAND) {
-                execvp(cmd->command.program, cmd->command.argv);
-                perror(cmd->command.program);
-                exit(1);
+                // Builtins in a pipeline run in the forked child
+                if (b)
+                    exit(b->fn(cmd->command.argc, cmd->command.argv));
+
+                exec_program(path, cmd->command.program, cmd->command.argv);
             }
             else {
                 // if it's not a simple command, recursion
@@ -162,127 +420,277 @@ void execute_pipe(node_t *node) {
                 exit(0);
             }
         }
+
+        started++;
+
+        // Parent: done with the previous read end and this stage's write end
+        if (prev_read >= 0)
+            close(prev_read);
+        if (i < n - 1) {
+            close(p[1]);
+            prev_read = p[0];
+        }
     }
 
-    for (int i = 0; i < n - 1; i++) {
-        close(pipes[i][0]);
-        close(pipes[i][1]);
+    if (started < n && prev_read >= 0)
+        close(prev_read); // setup aborted; drop the dangling read end
+
+    prof_end(PROF_PIPE_SETUP, t0);
+
+    t0 = prof_begin();
+
+    /* Collect the stages as they exit, in any order, so a slow stage 0
+     * never delays reaping the ones after it. Per-stage rusage keeps the
+     * in-order wait4 loop: the report reads in stage order anyway. */
+    if (!pipe_rusage) {
+        reap_pids(pids, started, pipe_early);
+        prof_end(PROF_PIPE_WAIT, t0);
+        free(pids);
+        return;
     }
-    
-    for (int i = 0; i < n; i++) {
-        waitpid(pids[i], NULL, 0);
+
+    for (int i = 0; i < started; i++) {
+        /* Per-stage accounting: user/sys come from the stage itself via
+         * wait4; real is measured from pipeline launch, so for a stage
+         * that finished while an earlier one was still being waited on
+         * it includes that wait. */
+        struct rusage ru;
+        wait4(pids[i], NULL, 0, &ru);
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        node_t *cmd = node->pipe.parts[i];
+        fprintf(stderr, "stage %d (%s): real %.3fs user %.3fs sys %.3fs\n",
+                i,
+                cmd->type == NODE_COMMAND ? cmd->command.program : "subtree",
+                (now.tv_sec - launch.tv_sec) +
+                    (now.tv_nsec - launch.tv_nsec) / 1e9,
+                ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6,
+                ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6);
     }
-    
+    prof_end(PROF_PIPE_WAIT, t0);
+
     free(pids);
-    free(pipes);
 }
 
-void execute_redirect(node_t *node) {    
+/*
+ * Save an fd out of the way (to >= 10, close-on-exec so children never see
+ * it) so it can be put back after the redirected node has run. Returns -1
+ * if the fd was not open to begin with.
+ */
+static int save_fd(int fd)
+{
+    return fcntl(fd, F_DUPFD_CLOEXEC, 10);
+}
+
+static void restore_fd(int saved, int fd)
+{
+    if (saved >= 0) {
+        dup2(saved, fd);
+        close(saved);
+    } else {
+        close(fd);
+    }
+}
+
+void execute_redirect(node_t *node) {
     node_t *child = node->redirect.child;
     int fd = node->redirect.fd;
     int mode = node->redirect.mode;
     char *target = node->redirect.target;
-    
+
+    // Redirected plain commands can spawn with file actions, skipping fork
+    if (use_spawn) {
+        pid_t spid;
+        uint64_t t0 = prof_begin();
+        if (spawn_command(child, node, &spid) == 0) {
+            prof_end(PROF_REDIRECT_SPAWN, t0);
+            int status;
+            t0 = prof_begin();
+            waitpid(spid, &status, 0);
+            prof_end(PROF_REDIRECT_WAIT, t0);
+            return;
+        }
+    }
+
+    /*
+     * Apply the redirection in this process, run the child node, then put
+     * the saved descriptors back. A forked grandchild just inherits the
+     * redirected fds, so `cmd > file` costs one fork instead of two, and a
+     * redirected builtin costs none.
+     */
+    int file_fd = -1;
+    int target_fd;
+    int saved_fd, saved_err = -1;
+
+    switch (mode) {
+        case REDIRECT_INPUT:
+            file_fd = open(target, O_RDONLY);
+            target_fd = STDIN_FILENO;
+            break;
+
+        case REDIRECT_OUTPUT:
+            // case >
+            file_fd = open(target, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            target_fd = (fd < 0) ? STDOUT_FILENO : fd;
+            break;
+
+        case REDIRECT_APPEND:
+            // case >>
+            file_fd = open(target, O_WRONLY | O_CREAT | O_APPEND, 0644);
+            target_fd = (fd < 0) ? STDOUT_FILENO : fd;
+            break;
+
+        case REDIRECT_DUP:
+            // case >& o <&
+            file_fd = node->redirect.fd2;
+            target_fd = fd;
+            break;
+
+        default:
+            fprintf(stderr, "Unknown redirect type: %d\n", mode);
+            return;
+    }
+
+    if (file_fd < 0) {
+        perror(target);
+        return;
+    }
+
+    // Builtin output buffered so far belongs to the old stdout
+    fflush(stdout);
+
+    saved_fd = save_fd(target_fd);
+    if (dup2(file_fd, target_fd) < 0) {
+        perror("dup2");
+        restore_fd(saved_fd, target_fd);
+        if (mode != REDIRECT_DUP)
+            close(file_fd);
+        return;
+    }
+
+    // fd < 0 on > and >> means stderr follows stdout into the file
+    if (fd < 0 && (mode == REDIRECT_OUTPUT || mode == REDIRECT_APPEND)) {
+        saved_err = save_fd(STDERR_FILENO);
+        dup2(file_fd, STDERR_FILENO);
+    }
+
+    if (mode != REDIRECT_DUP)
+        close(file_fd);
+
+    // Execute the command with the active redirection
+    run_command(child);
+
+    // Anything a builtin printed must land in the file, not the old stdout
+    fflush(stdout);
+
+    restore_fd(saved_fd, target_fd);
+    if (fd < 0 && (mode == REDIRECT_OUTPUT || mode == REDIRECT_APPEND))
+        restore_fd(saved_err, STDERR_FILENO);
+}
+
+/*
+ * Does running this subtree change shell-process state? True when it
+ * contains a state-mutating builtin (cd, exit, ...) or a detach, whose job
+ * entry belongs to the shell that starts it. Subtrees that do not are safe
+ * to run in-process without subshell isolation.
+ */
+static int tree_mutates_shell(node_t *node)
+{
+    if (!node)
+        return 0;
+
+    switch (node->type) {
+    case NODE_COMMAND: {
+        const struct builtin *b = builtin_lookup(node->command.program);
+        return b != NULL && (b->flags & BUILTIN_MUTATES_SHELL);
+    }
+
+    case NODE_PIPE:
+        // Pipeline parts always run in forked children already
+        return 0;
+
+    case NODE_SEQUENCE:
+        for (size_t i = 0; i < node->sequence.n_parts; i++)
+            if (tree_mutates_shell(node->sequence.parts[i]))
+                return 1;
+        return 0;
+
+    case NODE_REDIRECT:
+        return tree_mutates_shell(node->redirect.child);
+
+    case NODE_SUBSHELL:
+        // A nested subshell isolates whatever it contains
+        return 0;
+
+    case NODE_DETACH:
+        return 1;
+
+    default:
+        return 1;
+    }
+}
+
+void execute_subshell(node_t *node)
+{
+    node_t *child = node->subshell.child;
+
+    // Fork elision: no shell state can leak, so no isolation is needed
+    if (!tree_mutates_shell(child)) {
+        run_command(child);
+        return;
+    }
+
     pid_t pid = fork();
-    
+
     if (pid < 0) {
         perror("fork");
         return;
     }
-    
-    if (pid == 0) { 
-        // child process, restores default signal handlers       
-        int file_fd;
-        
-        switch (mode) {
-            case REDIRECT_INPUT:
-                file_fd = open(target, O_RDONLY);
-                if (file_fd < 0) {
-                    perror(target);
-                    exit(1);
-                }
-                
-                if (dup2(file_fd, STDIN_FILENO) < 0) {
-                    perror("dup2");
-                    exit(1);
-                }
-                
-                close(file_fd);
-                break;
-                
-            case REDIRECT_OUTPUT:
-                // case >
-                file_fd = open(target, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-                if (file_fd < 0) {
-                    perror(target);
-                    exit(1);
-                }
-                
-                int target_fd = (fd < 0) ? STDOUT_FILENO : fd;
-                
-                if (dup2(file_fd, target_fd) < 0) {
-                    perror("dup2");
-                    exit(1);
-                }
-                
-                if (fd < 0) {
-                    if (dup2(file_fd, STDERR_FILENO) < 0) {
-                        perror("dup2");
-                        exit(1);
-                    }
-                }
-                
-                close(file_fd);
-                break;
-                
-            case REDIRECT_APPEND:
-                // case >>
-                file_fd = open(target, O_WRONLY | O_CREAT | O_APPEND, 0644);
-                if (file_fd < 0) {
-                    perror(target);
-                    exit(1);
-                }
-                
-                target_fd = (fd < 0) ? STDOUT_FILENO : fd;
-                
-                if (dup2(file_fd, target_fd) < 0) {
-                    perror("dup2");
-                    exit(1);
-                }
-                
-                if (fd < 0) {
-                    if (dup2(file_fd, STDERR_FILENO) < 0) {
-                        perror("dup2");
-                        exit(1);
-                    }
-                }
-                
-                close(file_fd);
-                break;
-                
-            case REDIRECT_DUP:
-                // case >& o <&
-                if (dup2(node->redirect.fd2, fd) < 0) {
-                    perror("dup2");
-                    exit(1);
-                }
-                break;
-                
-            default:
-                fprintf(stderr, "Unknown redirect type: %d\n", mode);
-                exit(1);
-        }
 
-        // Execute the command with the active redirection
+    if (pid == 0) {
         run_command(child);
         exit(0);
     }
-    else {
-        int status;
-        if (waitpid(pid, &status, 0) < 0) {
-            perror("waitpid");
+
+    int status;
+    waitpid(pid, &status, 0);
+}
+
+void execute_detach(node_t *node)
+{
+    node_t *child = node->detach.child;
+
+    // A detached plain command execs directly, no intermediate child shell
+    const char *path = NULL;
+    int direct = child->type == NODE_COMMAND &&
+                 !builtin_lookup(child->command.program);
+    if (direct)
+        path = path_resolve(child->command.program);
+
+    pid_t pid = fork();
+
+    if (pid < 0) {
+        perror("fork");
+        return;
+    }
+
+    if (pid == 0) {
+        if (direct) {
+            signal(SIGINT, SIG_DFL);
+            signal(SIGQUIT, SIG_DFL);
+            signal(SIGTSTP, SIG_DFL);
+            exec_program(path, child->command.program, child->command.argv);
         }
+
+        // Child shell context for anything more complex
+        run_command(child);
+        exit(0);
     }
+
+    // Parent does not wait: record the job and return to the prompt
+    jobs_add(pid, child);
 }
 
 void run_command(node_t *node)
@@ -310,11 +718,11 @@ void run_command(node_t *node)
         break;
         
     case NODE_SUBSHELL:
-        fprintf(stderr, "not yet implemented\n");
+        execute_subshell(node);
         break;
         
     case NODE_DETACH:
-        fprintf(stderr, "not yet implemented\n");
+        execute_detach(node);
         break;
     
     default:
@@ -10,6 +10,14 @@ struct tree_node;
  */
 extern char *prompt;
 
+/*
+ * When set (the -p flag), independent parts of a sequence chain run
+ * concurrently, bounded by the number of cores, instead of one after the
+ * other. Parts that mutate shell state (cd, exit, ...) still act as
+ * barriers and run in order.
+ */
+extern int parallel_sequences;
+
 /*
  * Called once when the shell starts.
  */